@@ -98,6 +98,9 @@
 #define LONG_DELAY_T1_MS_MIN		3000
 #define LONG_DELAY_T1_MS_MAX		18000
 
+/* ʱ(currProtectorLongDelay.h)I2T/SI/VI/EI/DTǼܼҪѡ */
+#define LONG_DELAY_CURVE			LONG_DELAY_CURVE_I2T
+
 
 
 
@@ -8,7 +8,42 @@
 
 
 #define WARN_DISSHARKE_MS	500
-#define WARN_DISSHARKE_CNT   (WARN_DISSHARKE_MS/(1000/AN_COUNT_FREQ))
+#define WARN_DISSHARKE_CNT   (WARN_DISSHARKE_MS*AN_COUNT_FREQ/1000)
+
+/* ѿִУѿȦͨSWITCH_OFF_PULSE_MSϵ磬پSWITCH_OFF_CONFIRM_MS״̬ȷѷբ
+ * δբط壬SWITCH_OFF_PULSE_NUMδբϱբʧܡɵʱADC */
+#define SWITCH_OFF_PULSE_MS		50
+#define SWITCH_OFF_CONFIRM_MS	200
+#define SWITCH_OFF_PULSE_NUM	3
+
+/* ѿʱͳƣα¼֡ж֡ѿȦͨusʱж֡ȦͨʱӰ
+ * ֡ʱΪð֡һʱ̣ʵʷʱƵ */
+#define TRIP_LAT_HIST_NUM		12		/* 0<256usk[2^(k+7),2^(k+8))usһ>=2^18us */
+#define TRIP_LAT_HIST_SHIFT		8
+#define TRIP_LAT_DUMP_CMD		't'		/* Դյַʱͳ */
+
+typedef enum
+{
+	TRIP_STAGE_SHORT_INSTANT,
+	TRIP_STAGE_SHORT_DELAY,
+	TRIP_STAGE_LONG_DELAY,
+	TRIP_STAGE_NUM,
+}TripStageEnum;
+
+typedef struct
+{
+	uint32_t pickupUs;			/* ״γֵİ֡ʱ */
+	uint32_t decideUs;			/* жİ֡ʱ */
+	uint32_t tkOnUs;			/* ѿȦͨʱ */
+}TripStampDef;
+
+typedef struct
+{
+	TripStampDef last;			/* һζ */
+	uint32_t tripCnt;			/*  */
+	uint32_t latMaxUs;			/* ж֡Ȧͨʱ */
+	uint16_t hist[TRIP_LAT_HIST_NUM];	/* ж֡Ȧͨʱӷֲ */
+}TripLatDef;
 
 typedef enum
 {
@@ -53,6 +88,7 @@ typedef enum
 	SWITCH_WARN_REASON_SHORT_INSTANT = 0x16,
 	SWITCH_WARN_REASON_SWITCH_OFF_FAIL = 0x17,
 	SWITCH_WARN_REASON_RESWITCH_ON = 0x18,
+	SWITCH_WARN_REASON_MEM_LOW = 0x19,
 	SWITCH_WARN_REASON_SOFT_CONTROL = 0x1E,
 	SWITCH_WARN_REASON_HW_CONTROL = 0x1D,
 }SwitchWarnReasonEnum; 
@@ -92,6 +128,7 @@ typedef enum
 	WARN_EVT_RESWITCH_ON		= 0x00100000,
 	WARN_EVT_SOFT_CONTROL		= 0x00200000,
 	WARN_EVT_HW_CONTROL			= 0x00400000,
+	WARN_EVT_MEM_LOW			= 0x00800000,	/* ջ */
 }WarnEvtEnum;
 
 
@@ -103,6 +140,11 @@ typedef enum
 
 
 bool SwitchOffProtector(SwitchWarnReasonEnum reason, uint8_t phase);
+void BreakerWarnEvtReport(SwitchWarnReasonEnum reason);
+uint32_t BreakerWarnEvtFetch(void);
+uint32_t BreakerWarnEvtPeek(void);
+void TripLatPickupRun(uint8_t stageMask);
+void PrintTripLat(void);
 void BreakerProtectorInit(void);
 void ToggleSwitch(void);
 void ReSwitchOn(SwitchWarnReasonEnum reason);
@@ -6,6 +6,8 @@
 #include "breakerAdc.h"
 #include "stdbool.h"
 
+#define CURR_PROTECTOR_LOG		0
+
 #define ICW_DELAY_MS			750
 #define SHORT_INSTANT_CNT_DEF	3
 
@@ -14,12 +16,14 @@
 #define DELAY_ACTION_PERCENT		(110)
 #define SHORT_DELAY_ACTION_PERCENT	(100)
 
-#define INVERSE_TIME_Q_MAX		(90000)
 #define Q_DECAY_S				(15*60)
 
-#define AN_COUNT_PERIOD_DECAY	(INVERSE_TIME_Q_MAX/Q_DECAY_S/AN_COUNT_FREQ)
+/* ֹ·ڸСֵʱжϣֵȴ/λۼ
+ * CURR_QUIESCENT_BATCHںִһΣֵˢͬ */
+#define CURR_QUIESCENT_BATCH	10
 
-#define INVERSE_TIME_Q_MAX_STEP	(INVERSE_TIME_Q_MAX*1000/AN_COUNT_FREQ)
+/* ťS1~S6λɵλȷϺЧBUTTON_SETTLE_MS */
+#define CURR_KNOB_NUM			BUTTON_NUM
 
 
 #pragma pack(1)
@@ -61,11 +65,61 @@ typedef struct
 
 #pragma pack()
 
+/* ʽѭжϣNֻӱCURR_POLE_NUM */
+#define CURR_POLE_NUM		IABC_PHASE_NUM
+
+typedef struct
+{
+	uint16_t paraOffset;		/* üBreakerParaInfoDefеƫ */
+	uint8_t adcIdx;				/* üͨIDֵУ׼ʱѡüУ׼ϵ */
+	uint8_t bitMask;			/* üָʾλPHASE_x_BITMASK */
+}CurrPoleDef;
+
+#define CURR_POLE_PARA(info, pole)	((const breakerParaDef *)((const uint8_t *)(info) + currPoleTab[pole].paraOffset))
+
+/* ʱ޵ʱʱװ֮ÿڼ10ﶯʱ */
+typedef struct
+{
+	int32_t cnt;
+	bool isRun;
+}CurrCountDownDef;
+
+/* αֵADCֵ(Q8)currPoleTab˳ţֵ仯ʱCurrPickupFreshУ׼£
+ * ÿֻbreakerParaDef.msQ8ȽϣADC̵ֵΪ0xFFFFFFFF */
+typedef struct
+{
+	uint32_t longDelay[CURR_POLE_NUM];		/* ʱֵ */
+	uint32_t shortDelay[CURR_POLE_NUM];	/* ʱֵ */
+	uint32_t shortDelayDef[CURR_POLE_NUM];	/* ʱI^2tתΪʱ޵Ĺյ(8Ir2) */
+	uint32_t shortInstant[CURR_POLE_NUM];	/* ·˲ʱֵ */
+	uint32_t warning[CURR_POLE_NUM];		/* Ԥֵ */
+	uint32_t quiescent;						/* ͶμֵСֵڴֵ߿· */
+}CurrPickupMsDef;
+
+/* ֵãťλȷϱ仯ʱװصcurrProtectorCfg汾ż1¼
+ * ڲװأƵʱ仯ʱͬ¼ */
+typedef struct
+{
+	uint16_t ver;							/* ð汾ÿװؼ10Ϊδװ */
+	uint16_t countFreq;						/* װʱļƵAN_COUNT_FREQ */
+	uint8_t knob[CURR_KNOB_NUM];			/* ЧS1~S6λ */
+	bool isFactoryClose;					/* ˮ߼ʱʱر */
+	bool isFresh;							/* Ҫװ */
+}CurrSettingDef;
+
+typedef struct
+{
+	uint32_t fastCycles;			/* ߿· */
+	uint32_t fullCycles;			/* жϵ */
+}CurrPathStatDef;
+
 
 
 
 
 extern CurrProtectorCfgDef currProtectorCfg;
+extern CurrPickupMsDef currPickupMs;
+extern const CurrPoleDef currPoleTab[CURR_POLE_NUM];
 
 
 
@@ -73,6 +127,11 @@ extern CurrProtectorCfgDef currProtectorCfg;
 void CurrProtectorHandler(const BreakerParaInfoDef *const breakerInfo);
 void CurrProtectorReInit(void);
 uint32_t GetIcwDelayCnt(float an);
+void CurrPickupFresh(void);
+void GetCurrPathStat(CurrPathStatDef *stat);
+void CurrSettingInvalidate(void);
+uint16_t GetCurrSettingVer(void);
+bool CurrCountDownRun(CurrCountDownDef *countDown, int32_t total);
 void CurrProtectorStatusLed(void);
 bool IsFactoryMode(void);
 void PrintSysInfo( void );
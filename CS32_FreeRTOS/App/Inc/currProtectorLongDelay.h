@@ -8,6 +8,32 @@
 
 #define LONG_DELAY_LOG	0
 
+/* ʱʼ㣺ÿֻȽֵۼADCֵÿLONG_DELAY_EVAL_MSھֵ
+ * һԤʣදԤһʱڵʱ
+ * ʱȶʱ1ڣڴڱ仯ʱLONG_DELAY_EVAL_MS */
+#define LONG_DELAY_EVAL_MS	100
+
+/* ʱ壬6Ir1ʱʱΪt1r = I/Ir1
+ *   I2TIEC 60947-2 ȹأt = 36*t1/r^2
+ *   SI IEC 60255 ׼ʱޣt = (6^0.02-1)*t1/(r^0.02-1)
+ *   VI IEC 60255 ǳʱޣt = 5*t1/(r-1)
+ *   EI IEC 60255 ˷ʱޣt = 35*t1/(r^2-1)
+ *   DT ʱޣt = t1 */
+#define LONG_DELAY_CURVE_I2T	0
+#define LONG_DELAY_CURVE_SI		1
+#define LONG_DELAY_CURVE_VI		2
+#define LONG_DELAY_CURVE_EI		3
+#define LONG_DELAY_CURVE_DT		4
+#define LONG_DELAY_CURVE_NUM	5
+
+/* ʱÿanQ4irQ4Ϊֵ(AQ4)
+ * ͳһȡ6Ir1ʱt1ʱheatΪNULL */
+typedef struct
+{
+	uint64_t (*heat)(uint32_t anQ4, uint32_t irQ4);
+	const char *name;
+}LongDelayCurveDef;
+
 
 
 
@@ -28,8 +54,13 @@ void LongDelayProtectorReInit(void);
 void ClrLongDelayProtectFlag(void);
 uint8_t GetLongDelayT1sIdx(uint16_t ms);
 bool LongDelayHandler(const BreakerParaInfoDef *const breakerInfo);
+void LongDelayCool(uint16_t cycles);
 void SetLongDelayIr1(uint16_t ir1);
 uint16_t GetLongDelayT1Ms( void );
+uint8_t GetLongDelayCurve(void);
+void SetLongDelayCurve(uint8_t curve);
+const LongDelayCurveDef *GetLongDelayCurveDesc(void);
+void LongDelayCurveFresh(void);
 
 
 
@@ -11,6 +11,11 @@
 
 #define PROTECT_COST_MS		25 
 
+/* ʱI^2t-ONSHORT_DELAY_I2T_KNEE_IR2Ir2(Ir2 = gear%*Ir1)ʱ t = t2*(8*Ir2/I)^2 ﵽ󰴶ʱt2
+ * I^2t-OFFʱt2ڶֵSHORT_DELAY_RESET_MSۼ㣬ڼ䱣ֲ */
+#define SHORT_DELAY_I2T_KNEE_IR2	8
+#define SHORT_DELAY_RESET_MS		100
+
 typedef enum
 {
 	IR2_MUL_2_IR1,
@@ -63,6 +68,8 @@ uint8_t GetIr2DivIr1Idx( uint16_t div );
 uint8_t GetShortDelayT2mSIdx(uint16_t ms);
 void SetShortDelayT2mS(        uint16_t ms );
 bool ShortDelayHandler(const BreakerParaInfoDef *const breakerInfo);
+void ShortDelayI2tFresh(void);
+void ShortDelayCool(uint16_t cycles);
 
 
 
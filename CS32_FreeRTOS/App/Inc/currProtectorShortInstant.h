@@ -10,6 +10,14 @@
 #define SHORT_INSTANT_ACTION_PERCENT	100
 #define SHORT_INSTANT_LOG	0
 
+/* ADCģ⿴ŹӲѿۣ˲ʱֵIr3Ӧķֵֵжѿ */
+#define SHORT_INSTANT_HW_TRIP			1
+#define SHORT_INSTANT_HW_CREST_Q8		362		/* ֵ/ֵ(Q8)ҲΪ1.414 */
+#define SHORT_INSTANT_HW_MARGIN_PERCENT	100		/* ӲѿֵIr3İٷֱ */
+
+/* ڷֵΪѡ֡ȷϳIr3ȴSHORT_INSTANT_CNT_DEFھֵ */
+#define SHORT_INSTANT_FAST_PICKUP		1
+
 
 
 typedef enum
@@ -42,6 +50,8 @@ void ShortInstantProtectorReInit(void);
 void ClrShortInstantProtectFlag(void);
 uint8_t GetIr3DivIr1Idx( uint16_t div );
 bool ShortInstantHandler(const BreakerParaInfoDef *const breakerInfo);
+void ShortInstantHwTripFresh(void);
+void ShortInstantCool(uint16_t cycles);
 
 
 
@@ -6,6 +6,27 @@
 #include <stdbool.h>
 
 
+/* ڶԣʱ鳤Ϊ뱨 */
+#define STATIC_ASSERT(expr, name)		typedef char static_assert_##name[(expr) ? 1 : -1]
+
+#define FFT_R4_MAX_N					64		/* 4FFTתӱ˳ */
+#define ATAN_TAB_BITS					6		/* б[0,1]2^6ȷ */
+#define ATAN_TAB_N						(1 << ATAN_TAB_BITS)
+
+typedef struct
+{
+	uint32_t sum;						/* ֵۼӺ */
+	uint32_t sqrSum;					/* ֵƽ */
+	uint16_t max;						/* ֵ */
+	uint16_t min;						/* Сֵ */
+}SumStatDef;
+
+typedef struct
+{
+	int32_t s1;							/* Goertzel״̬s[n-1] */
+	int32_t s2;							/* Goertzel״̬s[n-2] */
+}GoertzelStateDef;
+
 
 
 
@@ -15,7 +36,11 @@
 
 uint8_t CountMod256(uint8_t *data, uint16_t len);
 uint32_t bcd2int(uint8_t *bcd, uint8_t len, bool isBig);
-float sqrSumAverSqrt(uint32_t *data, uint32_t len);
+uint32_t SqrtU32(uint32_t val);
+uint32_t Atan2X10Q4(int32_t y, int32_t x);
+void CountSumStat(const int16_t *data, uint16_t len, uint16_t stride, SumStatDef *stat);
+void GoertzelQ14(const int16_t *data, uint16_t len, uint16_t stride, int32_t coeffQ14, GoertzelStateDef *state);
+void FftR4Q15(int16_t *buf, uint16_t n);
 uint32_t CountMax(uint32_t *data, uint32_t len);
 void CountMaxOffset(uint32_t *data, uint16_t len);
 
@@ -34,7 +34,54 @@ extern osThreadId TaskEvtsHandle;
 osTimerId reSwitchTimerHandle;
 //static xQueueHandle  QueueBreakerMsgHandle;
 
+static void SwitchOffTimerCallback(void const *argument);
+static osStaticTimerDef_t switchOffTimerCB;
+osTimerStaticDef(SwitchOffTimer, SwitchOffTimerCallback, &switchOffTimerCB);
+static osTimerId switchOffTimerHandle = NULL;					/* ѿ弰բȷϵĵζʱ */
+static volatile SwitchCtrlStateEnum switchCtrlState = SWITCH_CTRL_STATE_NULL;
+static uint8_t switchOffPulseCnt = 0;							/* ѿѷ */
+static uint8_t switchOffIsPulse = 0;							/* ʱʱѿȦͨ״̬ */
+static volatile uint16_t switchOffRetryMs = 0;					/* ʱʧܴԵĶʱʱ(ms)0Ϊ */
+
+static TripLatDef tripLat[TRIP_STAGE_NUM];						/* αѿʱͳ */
+static uint32_t tripPickupUs[TRIP_STAGE_NUM];					/* αİ֡ʱ */
+static uint8_t tripPickupMask = 0;								/* ıΣ(1<<TripStageEnum)λ */
+
 static uint8_t switchStatePre = 0;
+static uint32_t warnEvts = WARN_EVT_NULL;						/* ϱĸ澯¼WarnEvtEnumλ */
+
+/* 澯ԭ澯¼λĶӦϵ */
+static const struct
+{
+	uint8_t reason;
+	uint32_t evt;
+}warnEvtTab[] =
+{
+	{SWITCH_WARN_REASON_NORMAL,				WARN_EVT_NORMAL},
+	{SWITCH_WARN_REASON_IDN_WARN,			WARN_EVT_IDN_WARN},
+	{SWITCH_WARN_REASON_IDN,				WARN_EVT_IDN},
+	{SWITCH_WARN_REASON_LACKN,				WARN_EVT_LACKN},
+	{SWITCH_WARN_REASON_OVERLOAD,			WARN_EVT_OVERLOAD},
+	{SWITCH_WARN_REASON_SHORT_DELAY,		WARN_EVT_SHORT_DELAY},
+	{SWITCH_WARN_REASON_LACKPHASE,			WARN_EVT_LACKPHASE},
+	{SWITCH_WARN_REASON_UNDERVOL,			WARN_EVT_UNDERVOL},
+	{SWITCH_WARN_REASON_OVERVOL,			WARN_EVT_OVERVOL},
+	{SWITCH_WARN_REASON_GND,				WARN_EVT_GND},
+	{SWITCH_WARN_REASON_POWROFF,			WARN_EVT_POWROFF},
+	{SWITCH_WARN_REASON_REMOTE,				WARN_EVT_REMOTE},
+	{SWITCH_WARN_REASON_KEY,				WARN_EVT_KEY},
+	{SWITCH_WARN_REASON_LOCK,				WARN_EVT_LOCK},
+	{SWITCH_WARN_REASON_HAND,				WARN_EVT_HAND},
+	{SWITCH_WARN_REASON_TRANSFORMER,		WARN_EVT_TRANSFORMER},
+	{SWITCH_WARN_REASON_SWITCH_ON_FAIL,		WARN_EVT_ON_FAIL},
+	{SWITCH_WARN_REASON_SET_CHG,			WARN_EVT_SET_CHG},
+	{SWITCH_WARN_REASON_SHORT_INSTANT,		WARN_EVT_SHORT_INSTANT},
+	{SWITCH_WARN_REASON_SWITCH_OFF_FAIL,	WARN_EVT_OFF_FAIL},
+	{SWITCH_WARN_REASON_RESWITCH_ON,		WARN_EVT_RESWITCH_ON},
+	{SWITCH_WARN_REASON_SOFT_CONTROL,		WARN_EVT_SOFT_CONTROL},
+	{SWITCH_WARN_REASON_HW_CONTROL,			WARN_EVT_HW_CONTROL},
+	{SWITCH_WARN_REASON_MEM_LOW,			WARN_EVT_MEM_LOW},
+};
 
 #if 0
 void BreakerMsgCreate(void)
@@ -113,6 +160,63 @@ long BreakerMsgGet(MsgDef *msg)
 #endif
 
 
+/*
+*********************************************************************************************************
+*	  : BreakerWarnEvtReport
+*	˵: ¼һϱĸ澯¼ͬһ¼δȡǰظֻ¼һ
+*	    : reason澯ԭ
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void BreakerWarnEvtReport(SwitchWarnReasonEnum reason)
+{
+	uint8_t i = 0;
+
+	for(i=0; i<sizeof(warnEvtTab)/sizeof(warnEvtTab[0]); i++)
+	{
+		if(reason == warnEvtTab[i].reason)
+		{
+			portENTER_CRITICAL();
+			warnEvts |= warnEvtTab[i].evt;
+			portEXIT_CRITICAL();
+			break;
+		}
+	}
+}
+
+/*
+*********************************************************************************************************
+*	  : BreakerWarnEvtFetch
+*	˵: ȡȫϱĸ澯¼
+*	    : 
+*	  ֵ: WarnEvtEnumλϣ¼ʱΪWARN_EVT_NULL
+*********************************************************************************************************
+*/
+uint32_t BreakerWarnEvtFetch(void)
+{
+	uint32_t evts = 0;
+
+	portENTER_CRITICAL();
+	evts = warnEvts;
+	warnEvts = WARN_EVT_NULL;
+	portEXIT_CRITICAL();
+
+	return evts;
+}
+
+/*
+*********************************************************************************************************
+*	  : BreakerWarnEvtPeek
+*	˵: 鿴ϱĸ澯¼ȡߣԴӡֻʹ
+*	    : 
+*	  ֵ: WarnEvtEnumλϣ¼ʱΪWARN_EVT_NULL
+*********************************************************************************************************
+*/
+uint32_t BreakerWarnEvtPeek(void)
+{
+	return warnEvts;
+}
+
 /* ʽ־λ */
 static void ClrBreakerProtectorFlags(void)
 {
@@ -121,24 +225,225 @@ static void ClrBreakerProtectorFlags(void)
 	ClrShortInstantProtectFlag();
 }
 
-void SwitchOff(void)
+/*
+*********************************************************************************************************
+*	  : SwitchOffTimerStart
+*	˵: ѿ۶ʱʱʱʧ(ȴ)ʱBreakerHandlerÿԣ
+*			  ѿͣڵǰ裺׶Ȧٶϵ磬״̬һֱΪѿУ֮ѿҲٷ
+*	    : msʱʱ
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void SwitchOffTimerStart(uint16_t ms)
+{
+	if(osOK == osTimerStart(switchOffTimerHandle, ms))
+	{
+		switchOffRetryMs = 0;
+	}
+	else
+	{
+		switchOffRetryMs = ms;
+		#if LOG_ON
+		log_t("Breaker - switch off timer start fail, retry\r\n");
+		#endif
+	}
+}
+
+/*
+*********************************************************************************************************
+*	  : SwitchOffPulse
+*	˵: ѿȦͨ粢ȶʱʱʧʱȦͨ磬֤ѿۣʱϵ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void SwitchOffPulse(void)
+{
+	switchOffPulseCnt++;
+	switchOffIsPulse = 1;
+	TkOn();
+	SwitchOffTimerStart(SWITCH_OFF_PULSE_MS);
+}
+
+/*
+*********************************************************************************************************
+*	  : SwitchOffTimerCallback
+*	˵: ѿ۶ʱڴڶʱִУϵ粢ʼբȷϣȷϴڽʱ
+*			  ״̬Ϊբɹط壬ϱբʧ
+*	    : argumentδʹ
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void SwitchOffTimerCallback(void const *argument)
+{
+	TkOff();										/* ȷϴģ⿴ŹжҲܽͨȦÿεھϵ磻ʱʧʱ
+													 * BreakerHandlerԣѿһε */
+	if(switchOffIsPulse)
+	{
+		switchOffIsPulse = 0;
+		SwitchOffTimerStart(SWITCH_OFF_CONFIRM_MS);
+	}
+	else if(0 == GetSwitchIoState())
+	{
+		switchCtrlState = SWITCH_CTRL_STATE_OFF_SUCCESS;
+		ClrBreakerProtectorFlags();				/* ѷբα¿ʼж */
+	}
+	else if(switchOffPulseCnt < SWITCH_OFF_PULSE_NUM)
+	{
+		SwitchOffPulse();
+	}
+	else
+	{
+		BreakerWarnEvtReport(SWITCH_WARN_REASON_SWITCH_OFF_FAIL);
+		switchCtrlState = SWITCH_CTRL_STATE_OFF_FAIL;
+		#if LOG_ON
+		log_t("Breaker - switch off fail after %d pulses\r\n", switchOffPulseCnt);
+		#endif
+	}
+}
+
+/*
+*********************************************************************************************************
+*	  : SwitchOff
+*	˵: ѿۣأȼբȷɶʱɣαжϡ
+*			  ѿ۹ٴεòظ
+*	    : 
+*	  ֵ: true-ηѿУfalse-ѿڽУδظ
+*********************************************************************************************************
+*/
+bool SwitchOff(void)
 {
-    TkOn();
-    osDelay(1000);
 	ClrBreakerProtectorFlags();
+	if(SWITCH_CTRL_STATE_OFFING == switchCtrlState)
+	{
+		return false;
+	}
+	switchCtrlState = SWITCH_CTRL_STATE_OFFING;
+	switchOffPulseCnt = 0;
+	SwitchOffPulse();
+
+	return true;
+}
+
+SwitchCtrlStateEnum GetSwitchCtrlState( void )
+{
+	return switchCtrlState;
+}
+
+/*
+*********************************************************************************************************
+*	  : TripLatPickupRun
+*	˵: ÿڸ¸α״̬ʱ¼ڰ֡ʱֵ̣ʱ
+*	    : stageMaskڳֵıΣ(1<<TripStageEnum)λ
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void TripLatPickupRun(uint8_t stageMask)
+{
+	uint8_t i = 0;
+
+	for(i=0; i<TRIP_STAGE_NUM; i++)
+	{
+		if((stageMask & ~tripPickupMask) & (1<<i))
+		{
+			tripPickupUs[i] = GetAdcFrameUs();
+		}
+	}
+	tripPickupMask = stageMask;
+}
+
+/*
+*********************************************************************************************************
+*	  : TripLatRecord
+*	˵: ¼һѿ۵֡ж֡Ȧͨʱ̣ж֡ȦͨʱӼֱͼ
+*			  ֻSwitchOffʵʷѿʱãȦж֡ͨ(ģ⿴Źжֱѿ)ʱʱӼΪ0
+*	    : stageı
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void TripLatRecord(TripStageEnum stage)
+{
+	TripLatDef *lat = &tripLat[stage];
+	uint32_t latUs = 0;
+	uint8_t k = 0;
+
+	lat->last.decideUs = GetAdcFrameUs();
+	lat->last.pickupUs = (tripPickupMask & (1<<stage)) ? tripPickupUs[stage] : lat->last.decideUs;
+	lat->last.tkOnUs = GetTkOnUs();
+	if((int32_t)(lat->last.tkOnUs - lat->last.decideUs) > 0)
+	{
+		latUs = lat->last.tkOnUs - lat->last.decideUs;
+	}
+
+	for(k = 0; (k < TRIP_LAT_HIST_NUM-1) && ((latUs >> (TRIP_LAT_HIST_SHIFT+k)) != 0); k++)
+	{
+	}
+	if(lat->hist[k] < 0xFFFF)
+	{
+		lat->hist[k]++;
+	}
+	lat->latMaxUs = (latUs > lat->latMaxUs) ? latUs : lat->latMaxUs;
+	lat->tripCnt++;
 }
 
 bool SwitchOffProtector(SwitchWarnReasonEnum reason, uint8_t phase)
 {
-	SwitchOff();
+	/* ѿڽʱδ壬붯ʱͳƣ԰Ѷ */
+	if(!SwitchOff())
+	{
+		return true;
+	}
+
+	if(SWITCH_WARN_REASON_SHORT_INSTANT == reason)
+	{
+		TripLatRecord(TRIP_STAGE_SHORT_INSTANT);
+	}
+	else if(SWITCH_WARN_REASON_SHORT_DELAY == reason)
+	{
+		TripLatRecord(TRIP_STAGE_SHORT_DELAY);
+	}
+	else if(SWITCH_WARN_REASON_OVERLOAD == reason)
+	{
+		TripLatRecord(TRIP_STAGE_LONG_DELAY);
+	}
     
 	return true;
 }
 
+/*
+*********************************************************************************************************
+*	  : PrintTripLat
+*	˵: αѿʱͳƣһжжȦͨʱӡʱӼֱͼ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void PrintTripLat(void)
+{
+	static const char *const stageName[TRIP_STAGE_NUM] = {"Inst", "Sd", "Ld"};
+	const TripLatDef *lat = NULL;
+	uint8_t i = 0;
+	uint8_t k = 0;
+
+	for(i=0; i<TRIP_STAGE_NUM; i++)
+	{
+		lat = &tripLat[i];
+		printf("[Trip-%s]:cnt %lu\tpickup->decide %lu us\tdecide->tk %ld us\tmax %lu us\r\n", stageName[i], lat->tripCnt,
+			lat->last.decideUs - lat->last.pickupUs, (long)(lat->last.tkOnUs - lat->last.decideUs), lat->latMaxUs);
+		printf("  hist(<%dus,x2):", 1<<TRIP_LAT_HIST_SHIFT);
+		for(k=0; k<TRIP_LAT_HIST_NUM; k++)
+		{
+			printf(" %d", lat->hist[k]);
+		}
+		printf("\r\n");
+	}
+}
+
 void BreakerProtectorInit(void)
 {
 	/* ʽ־λ */
 	ClrBreakerProtectorFlags();
+	switchOffTimerHandle = osTimerCreate(osTimer(SwitchOffTimer), osTimerOnce, NULL);
 	/* ȡⲿstateŵƽ״̬ */
 	switchStatePre = GetSwitchIoState();
 
@@ -187,6 +492,11 @@ void SwitchCtrlHandler(void)
 
 void BreakerHandler(const BreakerParaInfoDef *const breakerInfo)
 {	
+	if(0 != switchOffRetryMs)
+	{
+		SwitchOffTimerStart(switchOffRetryMs);		/* ѿ۶ʱϴʧܣ */
+	}
+	SwitchCtrlHandler();							/* ֺբ״̬仯(ºբ)ʱα־ */
 	CurrProtectorHandler(breakerInfo);
 }
 
@@ -1,5 +1,7 @@
 #include "currProtector.h"
 #include <stdbool.h>
+#include <string.h>
+#include <stddef.h>
 #include "breakerAdc.h"
 //#include "cmsis_os.h"
 #include "breaker.h"
@@ -22,6 +24,14 @@ extern uint8_t S5_VAL;
 extern uint8_t S6_VAL;
 
 CurrProtectorCfgDef currProtectorCfg;
+CurrPickupMsDef currPickupMs;
+
+const CurrPoleDef currPoleTab[CURR_POLE_NUM] =
+{
+	{offsetof(BreakerParaInfoDef, ia), IA_IDX, PHASE_A_BITMASK},
+	{offsetof(BreakerParaInfoDef, ib), IB_IDX, PHASE_B_BITMASK},
+	{offsetof(BreakerParaInfoDef, ic), IC_IDX, PHASE_C_BITMASK},
+};
 
 				/* S1_VAL: 0   1    2    3    4    5    6    7    8    9 */
 #if (DEV_TYPE_250A == DEV_TYPE)
@@ -43,6 +53,10 @@ static uint16_t ir3Percent[10] = {0, 400, 600, 700, 800, 1000, 1100, 1200, 1300,
 static uint16_t ir1Percent[10] = {0, 60, 65, 70, 75, 80, 85, 90, 95, 100};									/* {85, 90, 95, 100, 0, 60, 65, 70, 75, 80} */
 
 static bool isFactoryMode = false;
+static CurrPathStatDef currPathStat;						/* /·ڼ */
+static CurrSettingDef currSetting;							/* Чֵ */
+
+static void CurrQuiescentFresh(void);
 
 #define FACTORY_CLOSE_LONGDELAY_A   1000
 
@@ -56,10 +70,21 @@ bool IsFactoryMode(void)
     return flag;
 }
 
-void CurrParaFresh( const BreakerParaInfoDef *const breakerInfo )
+/*
+*********************************************************************************************************
+*	  : CurrSettingApply
+*	˵: ȷϵťλװظֵ汾ż1¼ε(ֵޡ߳
+*			  Ӳѿֵ·)ڵλˮ߼״̬Ƶʱ仯ʱ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void CurrSettingApply(void)
 {
+	const uint8_t *knob = currSetting.knob;
+
 	/* سʱ */
-    if(0==S1_VAL)											/* жϵǰS1ťλǷΪOFF  ڹ4==S1_VAL */
+    if(0==knob[0])											/* жϵǰS1ťλǷΪOFF  ڹ4==S1_VAL */
     {
         currProtectorCfg.longDelay.isEnable = false;		/* سʱܱر */	
         currProtectorCfg.longDelay.gear = CURRENT_IN_A;		/* λѡΪabout.hк궨ѡĵλ */
@@ -68,12 +93,12 @@ void CurrParaFresh( const BreakerParaInfoDef *const breakerInfo )
     {
         currProtectorCfg.longDelay.isEnable = true;			/* S1_VAL= 0򿪳ʱ */
     }
-    currProtectorCfg.longDelay.gear = ir1[S1_VAL];			/* λѡΪǰS1ťĵֵ */
-    currProtectorCfg.longDelay.tsMs = t1Ms[S2_VAL];			/* سʱʱ */
-    currProtectorCfg.longDelay.isInverseTime = true;		/* ʱޱܴ */
+    currProtectorCfg.longDelay.gear = ir1[knob[0]];			/* λѡΪǰS1ťĵֵ */
+    currProtectorCfg.longDelay.tsMs = t1Ms[knob[1]];			/* سʱʱ */
+    currProtectorCfg.longDelay.isInverseTime = (LONG_DELAY_CURVE_DT != GetLongDelayCurve());	/* ʱΪʱ */
 
 	/* ·ʱ */   
-	if(0==S3_VAL)											/* жϵǰS3ťλǷΪOFF  ڹ4==S3_VAL */
+	if(0==knob[2])											/* жϵǰS3ťλǷΪOFF  ڹ4==S3_VAL */
     {
         currProtectorCfg.shortDelay.isEnable = false;		/* ·ʱܹر */
     }
@@ -81,9 +106,9 @@ void CurrParaFresh( const BreakerParaInfoDef *const breakerInfo )
     {
         currProtectorCfg.shortDelay.isEnable = true;		/* ·ʱܴ */
     }
-	currProtectorCfg.shortDelay.gear = ir2Percent[S3_VAL];	/* λѡΪǰS3ťĵֵ */
-    currProtectorCfg.shortDelay.tsMs = t2Ms[S4_VAL];		/* ·ʱʱ */
-    if(S4_VAL < 5)											
+	currProtectorCfg.shortDelay.gear = ir2Percent[knob[2]];	/* λѡΪǰS3ťĵֵ */
+    currProtectorCfg.shortDelay.tsMs = t2Ms[knob[3]];		/* ·ʱʱ */
+    if(knob[3] < 5)											
     {
         currProtectorCfg.shortDelay.isInverseTime = false;	/* S4ťĵλǰ5λ֮䣬ʱޱرգʱޱ */
     }
@@ -93,7 +118,7 @@ void CurrParaFresh( const BreakerParaInfoDef *const breakerInfo )
     }
 
 	/* ·˲ʱ */
-	if(0==S5_VAL)											/* жϵǰS5ťλǷΪOFF  ڹ4==S5_VAL */
+	if(0==knob[4])											/* жϵǰS5ťλǷΪOFF  ڹ4==S5_VAL */
     {
         currProtectorCfg.shortInstant.isEnable = false;		/* ·˲ʱܹر */
     } 
@@ -101,9 +126,9 @@ void CurrParaFresh( const BreakerParaInfoDef *const breakerInfo )
     {
         currProtectorCfg.shortInstant.isEnable = true;		/* ·˲ʱܴ */
     }
-    currProtectorCfg.shortInstant.gear = ir3Percent[S5_VAL];/* ·˲ʱ */
+    currProtectorCfg.shortInstant.gear = ir3Percent[knob[4]];/* ·˲ʱ */
 
-    if(0==S6_VAL)
+    if(0==knob[5])
     {
         currProtectorCfg.overloadWarning.isEnable = false;	/* жϵǰS6ťλǷΪOFFǣԤܹر */
     } 
@@ -111,8 +136,8 @@ void CurrParaFresh( const BreakerParaInfoDef *const breakerInfo )
     {
         currProtectorCfg.overloadWarning.isEnable = true;	/* 򿪹Ԥ */
     }
-    currProtectorCfg.overloadWarning.ir1Percent = ir1Percent[S6_VAL];	/* ԤΧ */
-		if((0==S1_VAL)&&(0==S2_VAL)&&(0==S3_VAL)&&(0==S4_VAL)&&(0==S5_VAL)&&(0==S6_VAL))	/* ˮ߲ʱ6λťͳһOFFλԹ */
+    currProtectorCfg.overloadWarning.ir1Percent = ir1Percent[knob[5]];	/* ԤΧ */
+		if((0==knob[0])&&(0==knob[1])&&(0==knob[2])&&(0==knob[3])&&(0==knob[4])&&(0==knob[5]))	/* ˮ߲ʱ6λťͳһOFFλԹ */
 		{
 			#if (DEV_TYPE_250A == DEV_TYPE)
 			currProtectorCfg.longDelay.gear = 100;
@@ -130,10 +155,8 @@ void CurrParaFresh( const BreakerParaInfoDef *const breakerInfo )
 			currProtectorCfg.shortDelay.gear = 1500;
 			currProtectorCfg.shortInstant.gear = 2520;
 			#endif
-			/* жϣԭʼֵУֵǷˮֵ߲ */
-			if( (breakerInfo->ia.an > FACTORY_CLOSE_LONGDELAY_A) 
-				&& (breakerInfo->ib.an > FACTORY_CLOSE_LONGDELAY_A)
-				&& (breakerInfo->ic.an > FACTORY_CLOSE_LONGDELAY_A) )
+			/* ˮ߼ʱˮֵ߲رճʱʱ */
+			if(currSetting.isFactoryClose)
 				{
 					currProtectorCfg.longDelay.isEnable = false;		/* ǣرճʱ */
 					currProtectorCfg.shortDelay.isEnable = false;		/* ǣرն·ʱ */
@@ -149,6 +172,194 @@ void CurrParaFresh( const BreakerParaInfoDef *const breakerInfo )
 			isFactoryMode = false;								/* ˮ߼ģʽ־ر */
 			portEXIT_CRITICAL();
 		}
+
+	currSetting.countFreq = AN_COUNT_FREQ;
+	currSetting.isFresh = false;
+	if(0 == ++currSetting.ver)
+	{
+		currSetting.ver = 1;								/* 0Ϊδװ */
+	}
+
+	CurrPickupFresh();										/* յֵ¸ֵľֵ */
+	CurrQuiescentFresh();									/* Ͷĸθ¿· */
+	LongDelayCurveFresh();									/* յֵ³ʱߵĶ㳣 */
+	ShortDelayI2tFresh();									/* յֵ¶ʱI^2tĶ㳣 */
+	ShortInstantHwTripFresh();								/* յĶ·˲ʱֵADCģ⿴Źֵ */
+}
+
+/*
+*********************************************************************************************************
+*	  : CurrParaFresh
+*	˵: λȷϵλ仯װֵϱֵ仯¼λƽزȷʱ
+*			  ButtonDecodeдˮ߼״̬Ƶʱ仯ʱֻװءֻȽϱ仯
+*	    : breakerInfoڸˮ߼⵵λж
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void CurrParaFresh( const BreakerParaInfoDef *const breakerInfo )
+{
+	static uint16_t knobSeq = 0;						/* װصλı仯0Ϊδװصλ */
+	uint8_t knob[CURR_KNOB_NUM];
+	uint16_t seq = 0;
+	bool isSetChg = false;
+	bool isFactoryClose = false;
+	uint8_t i = 0;
+
+	/* ϵ״װأȴλȷ */
+	if(0 == currSetting.ver)
+	{
+		currSetting.isFresh = true;
+	}
+
+	seq = GetButtonGear(knob);
+	if(seq != knobSeq)
+	{
+		isSetChg = (0 != knobSeq);						/* ϵ״νϵװأϱ */
+		knobSeq = seq;
+		memcpy(currSetting.knob, knob, sizeof(knob));
+		currSetting.isFresh = true;
+	}
+
+	/* ˮ߼⵵λ(6ťΪOFF)£ˮֵ߲ʱرճʱ */
+	for(i=0; (i<CURR_KNOB_NUM) && (0 == currSetting.knob[i]); i++)
+	{
+	}
+	if(CURR_KNOB_NUM == i)
+	{
+		isFactoryClose = (GetParaAn(&breakerInfo->ia) > FACTORY_CLOSE_LONGDELAY_A) 
+				&& (GetParaAn(&breakerInfo->ib) > FACTORY_CLOSE_LONGDELAY_A)
+				&& (GetParaAn(&breakerInfo->ic) > FACTORY_CLOSE_LONGDELAY_A);
+	}
+	if(isFactoryClose != currSetting.isFactoryClose)
+	{
+		currSetting.isFactoryClose = isFactoryClose;
+		currSetting.isFresh = true;
+	}
+
+	if(currSetting.isFresh || (AN_COUNT_FREQ != currSetting.countFreq))
+	{
+		CurrSettingApply();
+	}
+	if(isSetChg)
+	{
+		BreakerWarnEvtReport(SWITCH_WARN_REASON_SET_CHG);
+		#if CURR_PROTECTOR_LOG
+		log_t("CurrProtector - setting changed, ver: %d\r\n", currSetting.ver);
+		#endif
+	}
+}
+
+/*
+*********************************************************************************************************
+*	  : CurrSettingInvalidate
+*	˵: ť;޸ز(糤ʱ)һװز
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void CurrSettingInvalidate(void)
+{
+	currSetting.isFresh = true;
+}
+
+uint16_t GetCurrSettingVer(void)
+{
+	return currSetting.ver;
+}
+
+/*
+*********************************************************************************************************
+*	  : CurrPickupFresh
+*	˵: ɵǰֵαУ׼ΪADCֵޣֵδ仯ʱֱӷ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void CurrPickupFresh(void)
+{
+	static float anPre[5] = {-1, -1, -1, -1, -1};
+	uint16_t Ir1 = GetLongDelayIr1();
+	float an[5];
+	uint8_t i = 0;
+
+	/* ȡʽԭֵȽʱһ */
+	an[0] = (uint16_t)(currProtectorCfg.longDelay.gear*DELAY_ACTION_PERCENT/100);
+	an[1] = (uint16_t)(currProtectorCfg.shortDelay.gear*Ir1*SHORT_DELAY_ACTION_PERCENT/100/100);
+	an[2] = (uint32_t)SHORT_DELAY_I2T_KNEE_IR2*currProtectorCfg.shortDelay.gear*Ir1/100;
+	an[3] = (uint16_t)(currProtectorCfg.shortInstant.gear*Ir1*SHORT_INSTANT_ACTION_PERCENT/100/100);
+	an[4] = 1.1f * (Ir1*currProtectorCfg.overloadWarning.ir1Percent / 100);
+
+	if(0 == memcmp(an, anPre, sizeof(an)))
+	{
+		return;
+	}
+	memcpy(anPre, an, sizeof(anPre));
+
+	for(i=0; i<CURR_POLE_NUM; i++)
+	{
+		currPickupMs.longDelay[i] = CountAnRawMsQ8(currPoleTab[i].adcIdx, an[0]);
+		currPickupMs.shortDelay[i] = CountAnRawMsQ8(currPoleTab[i].adcIdx, an[1]);
+		currPickupMs.shortDelayDef[i] = CountAnRawMsQ8(currPoleTab[i].adcIdx, an[2]);
+		currPickupMs.shortInstant[i] = CountAnRawMsQ8(currPoleTab[i].adcIdx, an[3]);
+		currPickupMs.warning[i] = CountAnRawMsQ8(currPoleTab[i].adcIdx, an[4]);
+	}
+}
+
+/*
+*********************************************************************************************************
+*	  : CurrQuiescentFresh
+*	˵: ȡͶμֵ޵СֵΪֹ·ޣξδͶʱΪ0xFFFFFFFF
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void CurrQuiescentFresh(void)
+{
+	uint32_t msMin = 0xFFFFFFFF;
+	uint8_t i = 0;
+
+	for(i=0; i<CURR_POLE_NUM; i++)
+	{
+		if(currProtectorCfg.longDelay.isEnable && (currPickupMs.longDelay[i] < msMin))
+		{
+			msMin = currPickupMs.longDelay[i];
+		}
+		if(currProtectorCfg.shortDelay.isEnable && (currPickupMs.shortDelay[i] < msMin))
+		{
+			msMin = currPickupMs.shortDelay[i];
+		}
+		if(currProtectorCfg.shortInstant.isEnable && (currPickupMs.shortInstant[i] < msMin))
+		{
+			msMin = currPickupMs.shortInstant[i];
+		}
+		if(currProtectorCfg.overloadWarning.isEnable && (currPickupMs.warning[i] < msMin))
+		{
+			msMin = currPickupMs.warning[i];
+		}
+	}
+	currPickupMs.quiescent = msMin;
+}
+
+/*
+*********************************************************************************************************
+*	  : CurrCountDownRun
+*	˵: ʱ޵ʱδʱװtotalʱ1
+*	    : CurrCountDownDef *countDown üʱ״̬
+*			   int32_t total               ʱ
+*	  ֵ: true-ѵﶯʱ
+*********************************************************************************************************
+*/
+bool CurrCountDownRun(CurrCountDownDef *countDown, int32_t total)
+{
+	if(!countDown->isRun)
+	{
+		countDown->isRun = true;
+		countDown->cnt = total;
+		return false;
+	}
+	countDown->cnt--;
+
+	return (countDown->cnt <= 0);
 }
 
 
@@ -189,11 +400,9 @@ static void overloadWarningHandler(const BreakerParaInfoDef *const breakerInfo)
         currProtectorCfg.overloadWarning.isInAlarm = false;
         return;
     }
-    /* iWarning = 1.1*ǰʱֵ*ԤΧ/100 */
-    float iWarning = 1.1f * (GetLongDelayIr1()*currProtectorCfg.overloadWarning.ir1Percent / 100) ;
-    
+    /* iWarning = 1.1*ǰʱֵ*ԤΧ/100ѻΪֵ */
 	/* ǰĵֵ > iWarning*/
-    if(breakerInfo->ia.an >= iWarning )
+    if(breakerInfo->ia.msQ8 >= currPickupMs.warning[0])
     {	
 		/* ־ */
         currProtectorCfg.overloadWarning.isInAlarm = true;
@@ -207,6 +416,8 @@ static void overloadWarningHandler(const BreakerParaInfoDef *const breakerInfo)
 
 void PrintSysInfo( void )
 {
+    AdcFrameStatDef frameStat;
+    CurrPathStatDef pathStat;
 
     float rmsAdcA = GetAnRawIaAver();
     float rmsAdcB = GetAnRawIbAver();
@@ -224,6 +435,14 @@ void PrintSysInfo( void )
     rmsAdcA, rmsAdcB, rmsAdcC, ia, ib, ic);
 
     printf("S1:%d S2:%d S3:%d S4:%d S5:%d S6:%d\r\n", S1_VAL, S2_VAL, S3_VAL, S4_VAL, S5_VAL, S6_VAL);
+
+    GetAdcFrameStat(&frameStat);
+    printf("[F]:%d.%02dHz\t[Fa]:%lu\t[Ha]:%d %d %d %d\t[Harm]:%lu/%lu cyc\r\n", GetPhaseFreqX100()/100, GetPhaseFreqX100()%100, BreakerFft.ia.fftPara.fn>>4,
+    BreakerFft.ia.fftPara.harm[0], BreakerFft.ia.fftPara.harm[1], BreakerFft.ia.fftPara.harm[2], BreakerFft.ia.fftPara.harm[3],
+    frameStat.harmCycles, frameStat.harmCyclesMax);
+    GetCurrPathStat(&pathStat);
+    printf("[Frame]:drop %lu overrun %lu catchup %lu\t[Slow]:stop timeout %lu\r\n", frameStat.dropCnt, frameStat.overrunCnt, frameStat.catchUpCnt, frameStat.slowScanFailCnt);
+    printf("[Path]:fast %lu full %lu\t[Set]:ver %d\t[Evt]:0x%08lx\t[Tk]:%d\r\n", pathStat.fastCycles, pathStat.fullCycles, GetCurrSettingVer(), BreakerWarnEvtPeek(), GetSwitchCtrlState());
     printf("\r\n");
 
 }
@@ -260,28 +479,157 @@ void CurrProtectorStatusLed(void)
 
 }   
 
+/*
+*********************************************************************************************************
+*	  : IsCurrQuiescent
+*	˵: жϱǷ߾ֹ·ھֵڹֵֵСֵ
+*			  ޴Ӳѿ
+*	    : breakerInfoڸ
+*	  ֵ: true-ξ
+*********************************************************************************************************
+*/
+static bool IsCurrQuiescent(const BreakerParaInfoDef *const breakerInfo)
+{
+	const breakerParaDef *para = NULL;
+	uint32_t msMax = 0;
+	uint8_t i = 0;
+
+	for(i=0; i<CURR_POLE_NUM; i++)
+	{
+		para = CURR_POLE_PARA(breakerInfo, i);
+		msMax = (para->msQ8 > msMax) ? para->msQ8 : msMax;
+		#if SHORT_INSTANT_FAST_PICKUP
+		msMax = (para->msFastQ8 > msMax) ? para->msFastQ8 : msMax;
+		#endif
+	}
+
+	return (msMax < currPickupMs.quiescent) && !IsAdcWatchdogTripped();
+}
+
+/*
+*********************************************************************************************************
+*	  : CurrPickupStage
+*	˵: жϱڳֵıΣڼ¼ѿʱӵ֡
+*	    : breakerInfoڸ
+*	  ֵ: ֵıΣ(1<<TripStageEnum)λ
+*********************************************************************************************************
+*/
+static uint8_t CurrPickupStage(const BreakerParaInfoDef *const breakerInfo)
+{
+	const breakerParaDef *para = NULL;
+	uint8_t stageMask = 0;
+	uint8_t i = 0;
+
+	for(i=0; i<CURR_POLE_NUM; i++)
+	{
+		para = CURR_POLE_PARA(breakerInfo, i);
+		#if SHORT_INSTANT_FAST_PICKUP
+		if((para->msQ8 >= currPickupMs.shortInstant[i]) || (para->msFastQ8 >= currPickupMs.shortInstant[i]))
+		#else
+		if(para->msQ8 >= currPickupMs.shortInstant[i])
+		#endif
+		{
+			stageMask |= 1<<TRIP_STAGE_SHORT_INSTANT;
+		}
+		if(para->msQ8 >= currPickupMs.shortDelay[i])
+		{
+			stageMask |= 1<<TRIP_STAGE_SHORT_DELAY;
+		}
+		if(para->msQ8 >= currPickupMs.longDelay[i])
+		{
+			stageMask |= 1<<TRIP_STAGE_LONG_DELAY;
+		}
+	}
+
+	return stageMask;
+}
+
+/*
+*********************************************************************************************************
+*	  : CurrProtectorCool
+*	˵: ִп·ڼεֵȴ/λ
+*	    : cycles
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void CurrProtectorCool(uint16_t cycles)
+{
+	currProtectorCfg.overloadWarning.isInAlarm = false;
+	ShortInstantCool(cycles);
+	ShortDelayCool(cycles);
+	LongDelayCool(cycles);
+}
+
+void GetCurrPathStat(CurrPathStatDef *stat)
+{
+	portENTER_CRITICAL();
+	*stat = currPathStat;
+	portEXIT_CRITICAL();
+}
+
 void CurrProtectorHandler(const BreakerParaInfoDef *const breakerInfo)
 {
+	static uint16_t quiescentCnt = 0;					/* ·δ */
+	static bool isQuiescentPre = false;
+	bool isTrip = false;
+
+	/* ֹ·ʱһԼʱָʾ֮ÿCURR_QUIESCENT_BATCHˢֵ */
+	if(IsCurrQuiescent(breakerInfo))
+	{
+		currPathStat.fastCycles++;
+		quiescentCnt++;
+		if(!isQuiescentPre || (quiescentCnt >= CURR_QUIESCENT_BATCH))
+		{
+			CurrProtectorCool(quiescentCnt);
+			quiescentCnt = 0;
+			CurrParaFresh(breakerInfo);
+		}
+		if(!isQuiescentPre)
+		{
+			TripLatPickupRun(0);
+		}
+		isQuiescentPre = true;
+		ADC_PROBE_LAP(ADC_PROBE_QUIESCENT);
+		return;
+	}
+	currPathStat.fullCycles++;
+	if(0 != quiescentCnt)
+	{
+		CurrProtectorCool(quiescentCnt);
+		quiescentCnt = 0;
+	}
+	isQuiescentPre = false;
+	ADC_PROBE_LAP(ADC_PROBE_QUIESCENT);
+
 	/* жϵǰťλֵȷʽĸֵ */
     CurrParaFresh(breakerInfo);
+	TripLatPickupRun(CurrPickupStage(breakerInfo));
+	ADC_PROBE_LAP(ADC_PROBE_SETTING);
 	/* Ԥ⴦ */
     overloadWarningHandler(breakerInfo);
+	ADC_PROBE_LAP(ADC_PROBE_WARNING);
 #if 1
 	/* ·˲ʱ */
-	if(ShortInstantHandler(breakerInfo))
+	isTrip = ShortInstantHandler(breakerInfo);
+	ADC_PROBE_LAP(ADC_PROBE_INSTANT);
+	if(isTrip)
 	{
 		return;
 	}
 #endif
 #if 1
 	/* ·ʱ */
-	if(ShortDelayHandler(breakerInfo))
+	isTrip = ShortDelayHandler(breakerInfo);
+	ADC_PROBE_LAP(ADC_PROBE_SHORT_DELAY);
+	if(isTrip)
 	{
 		return;
 	}
 #endif
 #if 1
-	if(LongDelayHandler(breakerInfo))
+	isTrip = LongDelayHandler(breakerInfo);
+	ADC_PROBE_LAP(ADC_PROBE_LONG_DELAY);
+	if(isTrip)
 	{
 		return;
 	}
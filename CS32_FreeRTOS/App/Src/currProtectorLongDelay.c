@@ -5,11 +5,84 @@
 #include "about.h"
 #include "breakerAdc.h"
 #include "memMgr.h"
+#include "usrLib.h"
+#include <string.h>
 
 
 
 static bool isProtected = false;
 
+/* ʱʱȼ䰴ѡ嶨ֵ֣ÿڼߵh(I)ۼƴﵽh(6*Ir1)*t1
+ * ʱ t = t1*h(6*Ir1)/h(I)ֵʱQ_DECAY_Sֵȴ0
+ * LONG_DELAY_EVAL_MS룬h(I)ɴڳֵڵƽֵһΡ
+ * ֵ߻Ƶʱ仯ʱLongDelayCurveFresh¼ */
+typedef struct
+{
+	uint8_t curve;
+	uint16_t ir1;
+	uint16_t tsMs;
+	uint16_t countFreq;
+	uint32_t irQ4;					/* Ir1(AQ4) */
+	uint64_t (*heat)(uint32_t anQ4, uint32_t irQ4);	/* ѡߵʱ޻δʱΪNULL */
+	uint64_t qMax;					/* h(6*Ir1)*t1*AN_COUNT_FREQ/1000 */
+	uint64_t qDecay;				/* ÿȴqMax/(Q_DECAY_S*AN_COUNT_FREQ) */
+	uint8_t evalFrames;				/* LONG_DELAY_EVAL_MS*AN_COUNT_FREQ/1000 */
+	int32_t dtCnt;					/* ʱ޶t1*AN_COUNT_FREQ/1000 */
+}LongDelayCurveParaDef;
+
+static LongDelayCurveParaDef longDelayCurvePara = {.curve = LONG_DELAY_CURVE_NUM};	/* ״εʱȻ¼ */
+static uint8_t longDelayCurve = LONG_DELAY_CURVE;
+
+/* log2(1+i/32)Q16 */
+static const uint16_t log2MantQ16[33] =
+{
+	    0,  2909,  5732,  8473, 11136, 13727, 16248, 18704, 21098, 23433, 25711,
+	27936, 30109, 32234, 34312, 36346, 38336, 40286, 42196, 44068, 45904, 47705,
+	49472, 51207, 52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047, 65535
+};
+
+#define SI_ALPHA_LN2_Q20	14536		/* 0.02*ln2Q20 */
+
+static uint64_t LongDelayHeatI2t(uint32_t anQ4, uint32_t irQ4);
+static uint64_t LongDelayHeatSi(uint32_t anQ4, uint32_t irQ4);
+static uint64_t LongDelayHeatVi(uint32_t anQ4, uint32_t irQ4);
+static uint64_t LongDelayHeatEi(uint32_t anQ4, uint32_t irQ4);
+
+static const LongDelayCurveDef longDelayCurveTab[LONG_DELAY_CURVE_NUM] =
+{
+	{LongDelayHeatI2t,	"I2t"},		/* LONG_DELAY_CURVE_I2T */
+	{LongDelayHeatSi,	"SI"},		/* LONG_DELAY_CURVE_SI */
+	{LongDelayHeatVi,	"VI"},		/* LONG_DELAY_CURVE_VI */
+	{LongDelayHeatEi,	"EI"},		/* LONG_DELAY_CURVE_EI */
+	{NULL,				"DT"},		/* LONG_DELAY_CURVE_DT */
+};
+
+/* ʱ״̬currPoleTab˳ */
+typedef struct
+{
+	uint64_t q;						/* ʱλͬѡߵ */
+	uint64_t msSum;					/* ڳֵڵADCֵ֮ */
+	uint8_t aboveCnt;				/* ڳֵ */
+	uint8_t belowCnt;				/* ڵֵ */
+	uint8_t armCnt;					/* Ԥʣද0ΪδԤ */
+	CurrCountDownDef countDown;		/* ʱ޵ʱ */
+}LongDelayPoleDef;
+
+static LongDelayPoleDef longDelayPole[CURR_POLE_NUM];
+static uint8_t evalCnt = 0;			/* Ѽ */
+
+/* ˮ߼ʱ(A) */
+#if (DEV_TYPE_250A == DEV_TYPE)
+#define LONG_DELAY_FACTORY_AN_MIN	270
+#define LONG_DELAY_FACTORY_AN_MAX	330
+#elif (DEV_TYPE_400A == DEV_TYPE)
+#define LONG_DELAY_FACTORY_AN_MIN	432
+#define LONG_DELAY_FACTORY_AN_MAX	528
+#elif (DEV_TYPE_630A == DEV_TYPE)
+#define LONG_DELAY_FACTORY_AN_MIN	675
+#define LONG_DELAY_FACTORY_AN_MAX	825
+#endif
+
 void ClrLongDelayProtectFlag(void)
 {
 	isProtected = false;
@@ -45,35 +118,182 @@ void SetLongDelayIsInverseTime(bool isInverse)
 	currProtectorCfg.longDelay.isInverseTime = isInverse;	
 }
 
+uint8_t GetLongDelayCurve(void)
+{
+	return longDelayCurve;
+}
+
+void SetLongDelayCurve(uint8_t curve)
+{
+	if(curve < LONG_DELAY_CURVE_NUM)
+	{
+		longDelayCurve = curve;
+		CurrSettingInvalidate();
+	}
+}
+
+const LongDelayCurveDef *GetLongDelayCurveDesc(void)
+{
+	return &longDelayCurveTab[longDelayCurve];
+}
+
+/* I2Th = I^2 */
+static uint64_t LongDelayHeatI2t(uint32_t anQ4, uint32_t irQ4)
+{
+	return (uint64_t)anQ4*anQ4;
+}
+
+/* VIh = I - Ir1 */
+static uint64_t LongDelayHeatVi(uint32_t anQ4, uint32_t irQ4)
+{
+	return (anQ4 > irQ4) ? (anQ4 - irQ4) : 0;
+}
+
+/* EIh = I^2 - Ir1^2 */
+static uint64_t LongDelayHeatEi(uint32_t anQ4, uint32_t irQ4)
+{
+	return (anQ4 > irQ4) ? ((uint64_t)anQ4*anQ4 - (uint64_t)irQ4*irQ4) : 0;
+}
+
+/*
+*********************************************************************************************************
+*	  : LongDelayHeatSi
+*	˵: ׼ʱ h = r^0.02-1(Q24)r = I/Ir1log2(r)λλü32βֵã
+*			  x = 0.02*ln(r)0.14e^x-1չԼ1e-3
+*	    : anQ4ֵ(AQ4)
+*			  irQ4Ir1(AQ4)
+*	  ֵ: (Q24)
+*********************************************************************************************************
+*/
+static uint64_t LongDelayHeatSi(uint32_t anQ4, uint32_t irQ4)
+{
+	uint32_t rQ16 = 0;
+	uint32_t m = 0;
+	uint32_t i = 0;
+	uint32_t log2Q16 = 0;
+	uint64_t x = 0;
+	uint64_t x2 = 0;
+	uint8_t msb = 16;
+
+	if((anQ4 <= irQ4) || (0 == irQ4))
+	{
+		return 0;
+	}
+	rQ16 = ((uint64_t)anQ4 << 16)/irQ4;										/* anQ42^20r2^15 */
+	while(rQ16 >> (msb+1))
+	{
+		msb++;
+	}
+	m = rQ16 >> (msb-16);													/* βһΪ[1,2)Q16 */
+	i = (m >> 11) & 0x1F;
+	log2Q16 = ((uint32_t)(msb-16) << 16) + log2MantQ16[i]
+			+ ((((uint32_t)log2MantQ16[i+1] - log2MantQ16[i])*(m & 0x7FF)) >> 11);
+
+	x = ((uint64_t)log2Q16*SI_ALPHA_LN2_Q20) >> 12;							/* 0.02*ln(r)Q24 */
+	x2 = (x*x) >> 24;
+	return x + x2/2 + ((x2*x) >> 24)/6;
+}
+
+/*
+*********************************************************************************************************
+*	  : LongDelayCurveFresh
+*	˵: ѡ㳤ʱĶÿȴߡIr1t1Ƶʾδ仯ʱֱӷأ
+*			  CurrParaFreshӦֵʱ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void LongDelayCurveFresh(void)
+{
+	LongDelayCurveParaDef *cp = &longDelayCurvePara;
+	const LongDelayCurveDef *desc = GetLongDelayCurveDesc();
+	uint16_t ir1 = GetLongDelayIr1();
+	uint16_t tsMs = currProtectorCfg.longDelay.tsMs;
+	uint16_t countFreq = AN_COUNT_FREQ;
+
+	if((longDelayCurve == cp->curve) && (ir1 == cp->ir1) && (tsMs == cp->tsMs) && (countFreq == cp->countFreq))
+	{
+		return;
+	}
+	cp->curve = longDelayCurve;
+	cp->ir1 = ir1;
+	cp->tsMs = tsMs;
+	cp->countFreq = countFreq;
+	cp->irQ4 = (uint32_t)ir1 << RMS_FRAC_BITS;
+	cp->heat = desc->heat;
+	cp->dtCnt = (uint32_t)tsMs*countFreq/1000;
+	cp->evalFrames = ((uint32_t)LONG_DELAY_EVAL_MS*countFreq/1000 > 0) ? ((uint32_t)LONG_DELAY_EVAL_MS*countFreq/1000) : 1;
+
+	if(NULL == desc->heat)
+	{
+		cp->qMax = 0;
+		cp->qDecay = 0;
+		return;
+	}
+	/* I2T(6*630*16)^2*18000*130 Լ8.4e1564λ */
+	cp->qMax = desc->heat(6*cp->irQ4, cp->irQ4)*tsMs*countFreq/1000;
+	cp->qDecay = cp->qMax/((uint32_t)Q_DECAY_S*countFreq);
+}
+
+/*
+*********************************************************************************************************
+*	  : LongDelayPoleEval
+*	˵: ڽʱüڵȴֵڰƽֵ
+*			  һμ룻Ԥⰴǰﶯʣ
+*	    : i
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void LongDelayPoleEval(uint8_t i)
+{
+	LongDelayPoleDef *pole = &longDelayPole[i];
+	const LongDelayCurveParaDef *cp = &longDelayCurvePara;
+	uint64_t decay = cp->qDecay*pole->belowCnt;
+	uint64_t h = 0;
+	uint64_t remain = 0;
+	uint32_t ms = 0;
+	uint32_t rawQ4 = 0;
+	uint32_t anQ4 = 0;
+
+	pole->q = (pole->q > decay) ? (pole->q - decay) : 0;
+	pole->armCnt = 0;
+	if(0 != pole->aboveCnt)
+	{
+		/* ƽֵƽ룺ȡʹÿڵϵͳƫСʱʱۼƳԵĶӳ */
+		ms = (uint32_t)((pole->msSum + pole->aboveCnt/2)/pole->aboveCnt);
+		rawQ4 = SqrtU32(ms);
+		if(ms - rawQ4*rawQ4 > rawQ4)
+		{
+			rawQ4++;
+		}
+		anQ4 = CountCalibAnQ4(currPoleTab[i].adcIdx, rawQ4);
+		h = cp->heat(anQ4, cp->irQ4);
+		pole->q += h*pole->aboveCnt;
+		if((0 != h) && (pole->q < cp->qMax))
+		{
+			remain = (cp->qMax - pole->q + h - 1)/h;
+			pole->armCnt = (remain <= cp->evalFrames) ? (uint8_t)remain : 0;
+		}
+	}
+	pole->msSum = 0;
+	pole->aboveCnt = 0;
+	pole->belowCnt = 0;
+}
+
 bool LongDelayProtector(const BreakerParaInfoDef *const breakerInfo)
 {
-	static double Qa = 0;
-	static double Qb = 0;
-	static double Qc = 0;
-	static bool isCountDownA = false;
-	static bool isCountDownB = false;
-	static bool isCountDownC = false;
-	static int32_t countDownNumA = 0;
-	static int32_t countDownNumB = 0;
-	static int32_t countDownNumC = 0;
-	uint16_t idz = currProtectorCfg.longDelay.gear*DELAY_ACTION_PERCENT/100;
-	double qDlt = 0;
-	bool actionFlag = false;
-	uint32_t gearIr1Mul6 = 6*GetLongDelayIr1();
-	//uint32_t sqr6Ir1An = gearIr1Mul6*gearIr1Mul6*currProtectorCfg.longDelay.tsMs;
-	double sqr6Ir1AnTs = 0;
+	LongDelayPoleDef *pole = NULL;
+	const breakerParaDef *para = NULL;
+	uint32_t anQ4 = 0;														/* ֵˮ߼ʱ */
+	bool isInverse = currProtectorCfg.longDelay.isInverseTime && (NULL != longDelayCurvePara.heat);
+	bool isEval = false;
+	bool isAbove = false;
+	bool isTrip = false;
+	uint8_t i = 0;
 
     if(!currProtectorCfg.longDelay.isEnable)
 	{
-        Qa = 0;
-        Qb = 0;
-        Qc = 0;
-        isCountDownA = false;
-        isCountDownB = false;
-        isCountDownC = false;
-        countDownNumA = 0;
-        countDownNumB = 0;
-        countDownNumC = 0;
+		memset(longDelayPole, 0, sizeof(longDelayPole));
         currProtectorCfg.longDelay.heatIncEvts = 0;
 		return false;
 	}
@@ -83,257 +303,147 @@ bool LongDelayProtector(const BreakerParaInfoDef *const breakerInfo)
 		return true;
 	}
 
-	/* A */
-	if(breakerInfo->ia.an > idz)
+	if(isInverse && (++evalCnt >= longDelayCurvePara.evalFrames))
 	{
-		if(currProtectorCfg.longDelay.isInverseTime)
-		{
-			sqr6Ir1AnTs = (double) ( ((double)gearIr1Mul6 / (double)breakerInfo->ia.an) * ((double)gearIr1Mul6 / (double)breakerInfo->ia.an) * (double)currProtectorCfg.longDelay.tsMs );	
-			qDlt =  (double)INVERSE_TIME_Q_MAX_STEP / sqr6Ir1AnTs;
-			Qa += qDlt;
-			if(Qa >= INVERSE_TIME_Q_MAX)
-			{
-                if(!IsFactoryMode())
-                {
-                    actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, PHASE_A_BITMASK);	
-                    if(actionFlag)
-                    {
-                        isProtected = true;
-                        return true;
-                    }
-                }
-			}
-		}
-		else
+		evalCnt = 0;
+		isEval = true;
+	}
+
+	for(i=0; i<CURR_POLE_NUM; i++)
+	{
+		pole = &longDelayPole[i];
+		para = CURR_POLE_PARA(breakerInfo, i);
+		isAbove = (para->msQ8 >= currPickupMs.longDelay[i]);
+
+		if(isInverse)
 		{
-			Qa = 0;
-			if(!isCountDownA)
+			/* ÿֻۼӾֵԤõʣڵݼ0 */
+			if(isAbove)
 			{
-				isCountDownA = true;
-				countDownNumA = currProtectorCfg.longDelay.tsMs / (1000/AN_COUNT_FREQ);
+				pole->msSum += para->msQ8;
+				pole->aboveCnt++;
+				isTrip = (0 != pole->armCnt) && (0 == --pole->armCnt);
 			}
 			else
 			{
-				countDownNumA--;
-				if(countDownNumA<=0)
-				{
-					actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, PHASE_A_BITMASK);
-					if(actionFlag)
-					{
-						isProtected = true;
-						#if LONG_DELAY_LOG
-						log_t("LongDelay - fixed protecter do\r\n");
-						#endif
-						return true;
-					}
-				}
+				pole->belowCnt++;
+				pole->armCnt = 0;
+				isTrip = false;
 			}
-		}
-        currProtectorCfg.longDelay.heatIncEvts |= PHASE_A_BITMASK;
-	}
-	else
-	{
-		if(currProtectorCfg.longDelay.isInverseTime)
-		{
-		    if(Qa > 0)
-            {      
-			    Qa -= (double)AN_COUNT_PERIOD_DECAY;
-                if(Qa < 0)
-                {
-                    Qa = 0;
-                }
-            }
-		}
-		else
-		{
-			Qa = 0;
-			isCountDownA = false;
-		}
-        currProtectorCfg.longDelay.heatIncEvts  &= ~PHASE_A_BITMASK;
-	}
-
-	/* B */
-	if(breakerInfo->ib.an > idz)
-	{
-		if(currProtectorCfg.longDelay.isInverseTime)
-		{
-			sqr6Ir1AnTs = (double) ( ((double)gearIr1Mul6 / (double)breakerInfo->ib.an) * ((double)gearIr1Mul6 / (double)breakerInfo->ib.an) * (double)currProtectorCfg.longDelay.tsMs );	
-			qDlt =  (double)INVERSE_TIME_Q_MAX_STEP / sqr6Ir1AnTs;
-			Qb += qDlt;
-			if(Qb >= INVERSE_TIME_Q_MAX)
+			if(isEval)
 			{
-                if(!IsFactoryMode())
-                {
-                    actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, PHASE_B_BITMASK);	
-                    if(actionFlag)
-                    {
-                        isProtected = true;
-                        return true;
-                    }
-                }
+				LongDelayPoleEval(i);
 			}
+			isTrip = (isTrip || (pole->q >= longDelayCurvePara.qMax)) && !IsFactoryMode();
 		}
 		else
 		{
-			Qb = 0;
-			if(!isCountDownB)
+			/* ֵʱ޸λ */
+			pole->q = 0;
+			if(isAbove)
 			{
-				isCountDownB = true;
-				countDownNumB = currProtectorCfg.longDelay.tsMs / (1000/AN_COUNT_FREQ);
+				isTrip = CurrCountDownRun(&pole->countDown, longDelayCurvePara.dtCnt);
 			}
 			else
 			{
-				countDownNumB--;
-				if(countDownNumB<=0)
-				{
-					actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, PHASE_B_BITMASK);
-					if(actionFlag)
-					{
-						isProtected = true;
-					#if LONG_DELAY_LOG
-						log_t("LongDelay - fixed protecter do\r\n");
-					#endif
-						return true;
-					}
-				}
+				pole->countDown.isRun = false;
+				isTrip = false;
 			}
 		}
-        currProtectorCfg.longDelay.heatIncEvts |= PHASE_B_BITMASK;
-	}
-	else
-	{
-		if(currProtectorCfg.longDelay.isInverseTime)
+		if(isTrip && SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, currPoleTab[i].bitMask))
+		{
+			isProtected = true;
+			#if LONG_DELAY_LOG
+			log_t("LongDelay - protecter do, pole: %d\r\n", i);
+			#endif
+			return true;
+		}
+		if(isAbove)
 		{
-            if(Qb > 0)
-            {      
-			    Qb -= (double)AN_COUNT_PERIOD_DECAY;
-                if(Qb < 0)
-                {
-                    Qb = 0;
-                }
-            }
+			currProtectorCfg.longDelay.heatIncEvts |= currPoleTab[i].bitMask;
 		}
 		else
 		{
-			Qb = 0;
-			isCountDownB = false;
+			currProtectorCfg.longDelay.heatIncEvts &= ~currPoleTab[i].bitMask;
 		}
-        currProtectorCfg.longDelay.heatIncEvts &= ~PHASE_B_BITMASK;
 	}
 
-	/* C */
-	if(breakerInfo->ic.an > idz)
-	{
-		if(currProtectorCfg.longDelay.isInverseTime)
-		{
-			sqr6Ir1AnTs = (double) ( ((double)gearIr1Mul6 / (double)breakerInfo->ic.an) * ((double)gearIr1Mul6 / (double)breakerInfo->ic.an) * (double)currProtectorCfg.longDelay.tsMs );	
-			qDlt =  (double)INVERSE_TIME_Q_MAX_STEP / sqr6Ir1AnTs;
-			Qc += qDlt;
-			if(Qc >= INVERSE_TIME_Q_MAX)
-			{
-                if(!IsFactoryMode())
-                {
-                    actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, PHASE_C_BITMASK);
-                    if(actionFlag)
-                    {
-                        isProtected = true;
-                        return true;
-                    }
-                }
-			}
-		}
-		else
+#ifdef LONG_DELAY_FACTORY_AN_MIN
+	/* ˮ߼⣺ҵڼⴰڲŶ */
+    if(IsFactoryMode())
+    {
+		for(i=0; i<CURR_POLE_NUM; i++)
 		{
-			Qc = 0;
-			if(!isCountDownC)
+			if(longDelayPole[i].q < longDelayCurvePara.qMax)
 			{
-				isCountDownC = true;
-				countDownNumC = currProtectorCfg.longDelay.tsMs / (1000/AN_COUNT_FREQ);
+				return false;
 			}
-			else
+			anQ4 = GetParaAnQ4(CURR_POLE_PARA(breakerInfo, i));
+			if((anQ4 <= (LONG_DELAY_FACTORY_AN_MIN<<RMS_FRAC_BITS)) || (anQ4 >= (LONG_DELAY_FACTORY_AN_MAX<<RMS_FRAC_BITS)))
 			{
-				countDownNumC--;
-				if(countDownNumC<=0)
-				{
-					actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, PHASE_C_BITMASK);
-					if(actionFlag)
-					{
-						isProtected = true;
-						#if LONG_DELAY_LOG
-						log_t("LongDelay - fixed protecter do\r\n");
-						#endif
-						return true;
-					}
-				}
+				return false;
 			}
 		}
-        currProtectorCfg.longDelay.heatIncEvts |= PHASE_C_BITMASK;
+		if(SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, PHASE_C_BITMASK))
+		{
+			isProtected = true;
+			return true;
+		}
+    }
+#endif
+
+	return false;
+}
+
+
+/*
+*********************************************************************************************************
+*	  : LongDelayCool
+*	˵: ֹ·ȼδڵٰcyclesȴʱ޸λ
+*	    : cycles
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void LongDelayCool(uint16_t cycles)
+{
+	uint64_t decay = longDelayCurvePara.qDecay*cycles;
+	uint8_t i = 0;
+
+	if(!currProtectorCfg.longDelay.isEnable)
+	{
+		memset(longDelayPole, 0, sizeof(longDelayPole));
+		currProtectorCfg.longDelay.heatIncEvts = 0;
+		return;
 	}
-	else
+	if(isProtected)
+	{
+		return;
+	}
+
+	evalCnt = 0;
+	for(i=0; i<CURR_POLE_NUM; i++)
 	{
-		if(currProtectorCfg.longDelay.isInverseTime)
+		if(currProtectorCfg.longDelay.isInverseTime && (NULL != longDelayCurvePara.heat))
 		{
-			if(Qc > 0)
-            {      
-			    Qc -= (double)AN_COUNT_PERIOD_DECAY;
-                if(Qc < 0)
-                {
-                    Qc = 0;
-                }
-            }
+			/* ۼƵﵽֵʱ趯 */
+			LongDelayPoleEval(i);
+			if((longDelayPole[i].q >= longDelayCurvePara.qMax) && !IsFactoryMode()
+				&& SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, currPoleTab[i].bitMask))
+			{
+				isProtected = true;
+				return;
+			}
+			longDelayPole[i].q = (longDelayPole[i].q > decay) ? (longDelayPole[i].q - decay) : 0;
 		}
 		else
 		{
-			Qc = 0;
-			isCountDownC = false;
+			longDelayPole[i].q = 0;
+			longDelayPole[i].countDown.isRun = false;
 		}
-        currProtectorCfg.longDelay.heatIncEvts &= ~PHASE_C_BITMASK;
 	}
-    
-    if(IsFactoryMode())
-    {
-        if( (Qa>=INVERSE_TIME_Q_MAX) && (Qb>=INVERSE_TIME_Q_MAX) && (Qc>=INVERSE_TIME_Q_MAX) )
-        {
-						#if (DEV_TYPE_250A == DEV_TYPE)
-             if((breakerInfo->ia.an > 270)&&(breakerInfo->ia.an < 330)&&(breakerInfo->ib.an > 270)&&(breakerInfo->ib.an < 330)&&(breakerInfo->ic.an > 270)&&(breakerInfo->ic.an < 330))
-								{
-										actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, PHASE_C_BITMASK);
-										if(actionFlag)
-										{
-												isProtected = true;
-												return true;
-										}								
-								}
-						#elif (DEV_TYPE_400A == DEV_TYPE)
-             if((breakerInfo->ia.an > 432)&&(breakerInfo->ia.an < 528)&&(breakerInfo->ib.an > 432)&&(breakerInfo->ib.an < 528)&&(breakerInfo->ic.an > 432)&&(breakerInfo->ic.an < 528))
-								{
-										actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, PHASE_C_BITMASK);
-										if(actionFlag)
-										{
-												isProtected = true;
-												return true;
-										}								
-								}
-						#elif (DEV_TYPE_630A == DEV_TYPE)
-             if((breakerInfo->ia.an > 675)&&(breakerInfo->ia.an < 825)&&(breakerInfo->ib.an > 675)&&(breakerInfo->ib.an < 825)&&(breakerInfo->ic.an > 675)&&(breakerInfo->ic.an < 825))
-								{
-										actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_OVERLOAD, PHASE_C_BITMASK);
-										if(actionFlag)
-										{
-												isProtected = true;
-												return true;
-										}								
-								}
-						#endif
-
-        }
-    }
-
-	return false;
+	currProtectorCfg.longDelay.heatIncEvts = 0;
 }
 
-
-
 void LongDelayProtectorReInit(void)
 {
 	currProtectorCfg.longDelay.gear = CURRENT_IN_A;
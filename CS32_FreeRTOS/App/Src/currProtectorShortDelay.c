@@ -6,11 +6,40 @@
 #include "about.h"
 #include "breakerAdc.h"
 #include "memMgr.h"
+#include <string.h>
 
 
 
 static bool isProtected = false;
 
+/* ʱI^2tۼƣÿۼh*1000I^2t-ONҵڹյ(8Ir2)ʱh = I^2h = յ^2
+ * ۼƴﵽ յ^2*t2*AN_COUNT_FREQ I^2t-OFFʱhΪյ^2ʱt2
+ * ʼۼʱԤȼբʱPROTECT_COST_MSʹբʱܶʱߡ
+ * ֵƵʱ仯ʱShortDelayI2tFresh¼㣬ÿֻһγۼӼȽ */
+typedef struct
+{
+	uint16_t ir1;
+	uint16_t gear;					/* Ir2/Ir1(%) */
+	uint16_t tsMs;
+	uint16_t countFreq;
+	bool isI2t;
+	uint16_t resetCnt;				/* λʱ */
+	uint32_t costQ;					/* բʱԤϵPROTECT_COST_MS*AN_COUNT_FREQ */
+	uint64_t kneeSq;				/* յ(AQ4)ƽ */
+	uint64_t qMax;					/* ۼkneeSq*t2*AN_COUNT_FREQ */
+}ShortDelayI2tDef;
+
+static ShortDelayI2tDef shortDelayI2t;
+
+/* ʱ״̬currPoleTab˳ */
+typedef struct
+{
+	uint64_t q;						/* I^2tۼ(A^2msAN_COUNT_FREQQ8)0ʾδʼۼ */
+	uint16_t belowCnt;				/* ۼڼڶֵ */
+}ShortDelayPoleDef;
+
+static ShortDelayPoleDef shortDelayPole[CURR_POLE_NUM];
+
 void ClrShortDelayProtectFlag(void)
 {
 	isProtected = false;
@@ -36,49 +65,55 @@ void SetShortDelayIsInverseTime(bool isInverse)
 	currProtectorCfg.shortDelay.isInverseTime = isInverse;	
 }
 
+/*
+*********************************************************************************************************
+*	  : ShortDelayI2tFresh
+*	˵: ʱI^2tۼƵĹյ㼰ۼIr1Ir2t2I^2tؼƵʾδ仯ʱֱӷأ
+*			  CurrParaFreshӦֵʱ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void ShortDelayI2tFresh(void)
+{
+	ShortDelayI2tDef *sd = &shortDelayI2t;
+	uint16_t ir1 = GetLongDelayIr1();
+	uint16_t gear = currProtectorCfg.shortDelay.gear;
+	uint16_t tsMs = currProtectorCfg.shortDelay.tsMs;
+	uint16_t countFreq = AN_COUNT_FREQ;
+	bool isI2t = currProtectorCfg.shortDelay.isInverseTime;
+	uint32_t kneeQ4 = 0;
+
+	if((ir1 == sd->ir1) && (gear == sd->gear) && (tsMs == sd->tsMs) && (countFreq == sd->countFreq) && (isI2t == sd->isI2t) && (0 != sd->qMax))
+	{
+		return;
+	}
+	sd->ir1 = ir1;
+	sd->gear = gear;
+	sd->tsMs = tsMs;
+	sd->countFreq = countFreq;
+	sd->isI2t = isI2t;
+	sd->resetCnt = (uint32_t)SHORT_DELAY_RESET_MS*countFreq/1000;
+	sd->costQ = (uint32_t)PROTECT_COST_MS*countFreq;
+
+	/* յ8Ir2gear1500%(8*15*800*16)^2*500*130 Լ1.5e1764λ */
+	kneeQ4 = ((uint32_t)SHORT_DELAY_I2T_KNEE_IR2*gear*ir1/100) << RMS_FRAC_BITS;
+	sd->kneeSq = (uint64_t)kneeQ4*kneeQ4;
+	sd->qMax = sd->kneeSq*tsMs*countFreq;
+}
+
 bool ShortDelayProtector(const BreakerParaInfoDef *const breakerInfo)
 {
-	static double Qa = 0;
-	static double Qb = 0;
-	static double Qc = 0;
-	static bool isCountDownA = false;
-	static bool isCountDownB = false;
-	static bool isCountDownC = false;
-	static int32_t countDownNumA = 0;
-	static int32_t countDownNumB = 0;
-	static int32_t countDownNumC = 0;
-	double qDlt = 0;
-	uint16_t Ir1 = GetLongDelayIr1();																			/* ȡǰʱֵ */
-	uint16_t actionAn = currProtectorCfg.shortDelay.gear*Ir1*SHORT_DELAY_ACTION_PERCENT/100/100;				/* ȡǰ·ʱֵ */
-    uint16_t actionAnA = actionAn;
-    uint16_t actionAnB = actionAn;
-    uint16_t actionAnC = actionAn;																				/* (currProtectorCfg.shortDelay.tsMs-25) / [(1000/50) - 1]*/
-	uint16_t delayCountDownCnt = (currProtectorCfg.shortDelay.tsMs-PROTECT_COST_MS) / (1000/AN_COUNT_FREQ) - 1; 
-	uint16_t delayTotalCountDownCnt = 0;
-	bool actionFlag = false;
-	uint32_t gearIr1Mul8 = 8*currProtectorCfg.shortDelay.gear*Ir1;												/* 8Ir2 */
-	//uint32_t sqr8Ir1MulTs = gearIr1Mul8*gearIr1Mul8*currProtectorCfg.shortDelay.tsMs;
-	double sqr8Ir1An = 0; 	//(gearIr1Mul8/breakerInfo->ia.an/100)
-	static uint8_t disturbCntA = 0;
-	static uint8_t disturbCntB = 0;
-	static uint8_t disturbCntC = 0;
-	uint32_t icwDelayCnt = 0;
+	ShortDelayPoleDef *pole = NULL;
+	const breakerParaDef *para = NULL;
+	uint32_t anQ4 = 0;																							/* ֵI^2tλ */
+	uint64_t h = 0;
+	uint8_t i = 0;
 
 	/* ·ʱδ */
 	if(!currProtectorCfg.shortDelay.isEnable)
 	{
-        Qa = 0;
-        Qb = 0;
-        Qc = 0;
-        isCountDownA = false;
-        isCountDownB = false;
-        isCountDownC = false;
-        countDownNumA = 0;
-        countDownNumB = 0;
-        countDownNumC = 0;
-        disturbCntA = 0;
-        disturbCntB = 0;
-        disturbCntC = 0;
+		memset(shortDelayPole, 0, sizeof(shortDelayPole));
         currProtectorCfg.shortDelay.heatIncEvts = 0;
 		return false;
 	}
@@ -88,398 +123,103 @@ bool ShortDelayProtector(const BreakerParaInfoDef *const breakerInfo)
 		return true;
 	}
 
-
-	/** A **/
-	icwDelayCnt = GetIcwDelayCnt(breakerInfo->ia.an);
-	delayTotalCountDownCnt = delayCountDownCnt + icwDelayCnt;
-	if(breakerInfo->ia.an > actionAnA)
+	for(i=0; i<CURR_POLE_NUM; i++)
 	{
-		if(!currProtectorCfg.shortDelay.isInverseTime) //ʱ
+		pole = &shortDelayPole[i];
+		para = CURR_POLE_PARA(breakerInfo, i);
+
+		/* ڶֵۼ֣λʱ */
+		if(para->msQ8 < currPickupMs.shortDelay[i])
 		{
-			Qa = 0;
-			if(!isCountDownA)
+			if((0 != pole->q) && (++pole->belowCnt >= shortDelayI2t.resetCnt))
 			{
-				isCountDownA = true;
-				countDownNumA = delayTotalCountDownCnt;
-				#if SHORT_DELAY_LOG
-				log_t("ShortDelay - fixed delay start, an: %dA, actionAnA: %dA, delay: %dms\r\n", breakerInfo->ia.an, actionAnA, currProtectorCfg.shortDelay.tsMs);
-				#endif
-			}
-			else
-			{
-				countDownNumA--;
-				if(countDownNumA<=0)
-				{
-					actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_DELAY, PHASE_A_BITMASK);
-					if(actionFlag)
-					{
-						isProtected = true;
-						#if SHORT_DELAY_LOG
-						log_t("ShortDelay - fixed protecter do\r\n");
-						#endif
-						return true;
-					}
-					isCountDownA = false;
-					countDownNumA = delayTotalCountDownCnt;
-				}
+				pole->q = 0;
 			}
+			currProtectorCfg.shortDelay.heatIncEvts &= ~currPoleTab[i].bitMask;
+			continue;
 		}
-		else
-		{
-			if(breakerInfo->ia.an > gearIr1Mul8) //ʱ
-			{
-				if(!isCountDownA)
-				{
-					isCountDownA = true;
-					countDownNumA = delayTotalCountDownCnt;
-					#if SHORT_DELAY_LOG
-					log_t("ShortDelay - fixed delay start, an: %dA, actionAnA: %dA, delay: %dms\r\n", breakerInfo->ia.an, actionAnA, currProtectorCfg.shortDelay.tsMs);
-					#endif
-				}
-				else
-				{
-					countDownNumA--;
-					if(countDownNumA<=0)
-					{
-						actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_DELAY, PHASE_A_BITMASK);
-						if(actionFlag)
-						{
-							isProtected = true;
-							#if SHORT_DELAY_LOG
-							log_t("ShortDelay - fixed protecter do\r\n");
-							#endif
-							return true;
-						}
-						isCountDownA = false;
-						countDownNumA = delayTotalCountDownCnt;
-					}
-				}
+		pole->belowCnt = 0;
 
-			}
-			else //ʱ
-			{		
-				sqr8Ir1An = ((double)gearIr1Mul8) / ((double)breakerInfo->ia.an) / ((double)100);
-				sqr8Ir1An *= sqr8Ir1An;
-				qDlt = INVERSE_TIME_Q_MAX_STEP/( sqr8Ir1An * currProtectorCfg.shortDelay.tsMs); 
-				Qa += qDlt;
-				#if SHORT_DELAY_LOG
-				log_t("ShortDelay - qA: %lu, qDlt: %lu, an: %d\r\n", Qa, qDlt, breakerInfo->ia.an);
-				#endif
-				if(Qa >= INVERSE_TIME_Q_MAX)
-				{
-					actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_DELAY, PHASE_A_BITMASK);	
-					if(actionFlag)
-					{
-						isProtected = true;
-						#if SHORT_DELAY_LOG
-						log_t("ShortDelay - inverse protecter do\r\n");
-						#endif
-						return true;
-					}
-				}
-			}
-		}
-        currProtectorCfg.shortDelay.heatIncEvts |= PHASE_A_BITMASK;
-	}
-	else
-	{
-		if(currProtectorCfg.shortDelay.isInverseTime)
+		/* I^2tΰʵʵۼƣյϼI^2t-OFFյۼƼʱ */
+		if(shortDelayI2t.isI2t && (para->msQ8 < currPickupMs.shortDelayDef[i]))
 		{
-            if(Qa > 0)
-            {      
-			    Qa -= (double)AN_COUNT_PERIOD_DECAY;
-                if(Qa < 0)
-                {
-                    Qa = 0;
-                }
-            }
+			anQ4 = GetParaAnQ4(para);
+			h = (uint64_t)anQ4*anQ4;
 		}
 		else
 		{
-			Qa = 0;
-			if(isCountDownA)
-			{
-				disturbCntA++;
-				if(disturbCntA>=5)
-				{
-					if(countDownNumA <= delayTotalCountDownCnt)
-					{
-						countDownNumA++;
-					}
-					disturbCntA = 0;
-				}
-			}
-			else
-			{
-				disturbCntA = 0;
-			}
+			h = shortDelayI2t.kneeSq;
 		}
-        currProtectorCfg.shortDelay.heatIncEvts &= ~PHASE_A_BITMASK;
-	}
-
-	/** B **/
-	icwDelayCnt = GetIcwDelayCnt(breakerInfo->ib.an);
-	delayTotalCountDownCnt = delayCountDownCnt + icwDelayCnt;
-	if(breakerInfo->ib.an > actionAnB)
-	{
-		if(!currProtectorCfg.shortDelay.isInverseTime) //ʱ
+		if(0 == pole->q)
 		{
-			Qb = 0;
-			if(!isCountDownB)
-			{
-				isCountDownB = true;
-				countDownNumB = delayTotalCountDownCnt;
+			pole->q = h*shortDelayI2t.costQ;
 			#if SHORT_DELAY_LOG
-				log_t("ShortDelay - fixed delay start, an: %dA, actionAnB: %dA, delay: %dms\r\n", breakerInfo->ib.an, actionAnB, currProtectorCfg.shortDelay.tsMs);
+			log_t("ShortDelay - start, pole: %d, I2t: %d, delay: %dms\r\n", i, shortDelayI2t.isI2t, currProtectorCfg.shortDelay.tsMs);
 			#endif
-				
-			}
-			else
-			{
-				countDownNumB--;
-				if(countDownNumB<=0)
-				{
-					actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_DELAY, PHASE_B_BITMASK);
-					if(actionFlag)
-					{
-						isProtected = true;
-					#if SHORT_DELAY_LOG
-						log_t("ShortDelay - fixed protecter do\r\n");
-					#endif
-						return true;
-					}
-					isCountDownB = false;
-					countDownNumB = delayTotalCountDownCnt;
-				}
-			}
 		}
-		else
+		pole->q += h*1000;
+		if(pole->q >= shortDelayI2t.qMax)
 		{
-			if(breakerInfo->ib.an > gearIr1Mul8) //ʱ
+			pole->q = 0;								/* բδɹʱۼ */
+			if(SwitchOffProtector(SWITCH_WARN_REASON_SHORT_DELAY, currPoleTab[i].bitMask))
 			{
-				if(!isCountDownB)
-				{
-					isCountDownB = true;
-					countDownNumB = delayTotalCountDownCnt;
+				memset(shortDelayPole, 0, sizeof(shortDelayPole));	/* Ѷڼ䲻жϣغբۼ */
+				isProtected = true;
 				#if SHORT_DELAY_LOG
-					log_t("ShortDelay - fixed delay start, an: %dA, actionAnB: %dA, delay: %dms\r\n", breakerInfo->ib.an, actionAnB, currProtectorCfg.shortDelay.tsMs);
+				log_t("ShortDelay - protecter do, pole: %d\r\n", i);
 				#endif
-				}
-				else
-				{
-					countDownNumB--;
-					if(countDownNumB<=0)
-					{
-						actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_DELAY, PHASE_B_BITMASK);
-						if(actionFlag)
-						{
-							isProtected = true;
-							#if SHORT_DELAY_LOG
-							log_t("ShortDelay - fixed protecter do\r\n");
-							#endif
-							return true;
-						}
-						isCountDownB = false;
-						countDownNumB = delayTotalCountDownCnt;
-					}
-				}
-
-			}
-			else //ʱ
-			{
-				sqr8Ir1An = ((double)gearIr1Mul8) / ((double)breakerInfo->ib.an) / ((double)100);
-				sqr8Ir1An *= sqr8Ir1An;
-				qDlt = INVERSE_TIME_Q_MAX_STEP/( sqr8Ir1An * currProtectorCfg.shortDelay.tsMs); 
-				Qb += qDlt;
-			#if SHORT_DELAY_LOG
-				log_t("ShortDelay - qA: %lu, qDlt: %lu, an: %d\r\n", Qb, qDlt, breakerInfo->ib.an);
-			#endif
-				if(Qb >= INVERSE_TIME_Q_MAX)
-				{
-					actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_DELAY, PHASE_B_BITMASK);	
-					if(actionFlag)
-					{
-						isProtected = true;
-						#if SHORT_DELAY_LOG
-						log_t("ShortDelay - inverse protecter do\r\n");
-						#endif
-						return true;
-					}
-				}
+				return true;
 			}
 		}
-        currProtectorCfg.shortDelay.heatIncEvts |= PHASE_B_BITMASK;
+        currProtectorCfg.shortDelay.heatIncEvts |= currPoleTab[i].bitMask;
+	}
+
+	return false;
+}
+
+/*
+*********************************************************************************************************
+*	  : ShortDelayCool
+*	˵: ֹ·ڶֵcyclesڣۼƵڶֵʱ䣬λʱ伴
+*	    : cycles
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void ShortDelayCool(uint16_t cycles)
+{
+	ShortDelayPoleDef *pole = NULL;
+	uint8_t i = 0;
+
+	if(!currProtectorCfg.shortDelay.isEnable)
+	{
+		memset(shortDelayPole, 0, sizeof(shortDelayPole));
+        currProtectorCfg.shortDelay.heatIncEvts = 0;
+		return;
 	}
-	else
+	if(isProtected)
 	{
-		if(currProtectorCfg.shortDelay.isInverseTime)
-		{
-			if(Qb > 0)
-            {      
-			    Qb -= (double)AN_COUNT_PERIOD_DECAY;
-                if(Qb < 0)
-                {
-                    Qb = 0;
-                }
-            }
-		}
-		else
-		{
-			Qb = 0;
-			if(isCountDownB)
-			{
-				disturbCntB++;
-				if(disturbCntB>=5)
-				{
-					if(countDownNumB <= delayTotalCountDownCnt)
-					{
-						countDownNumB++;
-					}
-					disturbCntB = 0;
-				}
-			}
-			else
-			{
-				disturbCntB = 0;
-			}
-		}
-        currProtectorCfg.shortDelay.heatIncEvts &= ~PHASE_B_BITMASK;
+		return;
 	}
 
-	/** C **/
-	icwDelayCnt = GetIcwDelayCnt(breakerInfo->ic.an);
-	delayTotalCountDownCnt = delayCountDownCnt + icwDelayCnt;
-	if(breakerInfo->ic.an > actionAnC)
+	for(i=0; i<CURR_POLE_NUM; i++)
 	{
-		if(!currProtectorCfg.shortDelay.isInverseTime) //ʱ
+		pole = &shortDelayPole[i];
+		if(0 == pole->q)
 		{
-			Qc = 0;
-			if(!isCountDownC)
-			{
-				isCountDownC = true;
-				countDownNumC = delayTotalCountDownCnt;
-		#if SHORT_DELAY_LOG
-				log_t("ShortDelay - fixed delay start, an: %dA, actionAnC: %dA, delay: %dms\r\n", breakerInfo->ic.an, actionAnC, currProtectorCfg.shortDelay.tsMs);
-		#endif
-				
-			}
-			else
-			{
-				countDownNumC--;
-				if(countDownNumC<=0)
-				{
-					actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_DELAY, PHASE_C_BITMASK);
-					if(actionFlag)
-					{
-						isProtected = true;
-				#if SHORT_DELAY_LOG
-						log_t("ShortDelay - fixed protecter do\r\n");
-				#endif
-						return true;
-					}
-					isCountDownC = false;
-					countDownNumC = delayTotalCountDownCnt;
-				}
-			}
+			continue;
 		}
-		else
-		{
-			if(breakerInfo->ic.an > gearIr1Mul8) //ʱ
-			{
-				if(!isCountDownC)
-				{
-					isCountDownC = true;
-					countDownNumC = delayTotalCountDownCnt;
-			#if SHORT_DELAY_LOG
-					log_t("ShortDelay - fixed delay start, an: %dA, actionAnC: %dA, delay: %dms\r\n", breakerInfo->ic.an, actionAnC, currProtectorCfg.shortDelay.tsMs);
-			#endif
-				}
-				else
-				{
-					countDownNumC--;
-					if(countDownNumC<=0)
-					{
-						actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_DELAY, PHASE_C_BITMASK);
-						if(actionFlag)
-						{
-							isProtected = true;
-					#if SHORT_DELAY_LOG
-							log_t("ShortDelay - fixed protecter do\r\n");
-					#endif
-							return true;
-						}
-						isCountDownC = false;
-						countDownNumC = delayTotalCountDownCnt;
-					}
-				}
-
-			}
-			else //ʱ
-			{
-				sqr8Ir1An = ((double)gearIr1Mul8) / ((double)breakerInfo->ic.an) / ((double)100);
-				sqr8Ir1An *= sqr8Ir1An;
-				qDlt = INVERSE_TIME_Q_MAX_STEP/( sqr8Ir1An * currProtectorCfg.shortDelay.tsMs); 
-				Qc += qDlt;
-		#if SHORT_DELAY_LOG
-				log_t("ShortDelay - qA: %lu, qDlt: %lu, an: %d\r\n", Qc, qDlt, breakerInfo->ic.an);
-		#endif
-				if(Qc >= INVERSE_TIME_Q_MAX)
-				{
-					actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_DELAY, PHASE_C_BITMASK);	
-					if(actionFlag)
-					{
-						isProtected = true;
-				#if SHORT_DELAY_LOG
-						log_t("ShortDelay - inverse protecter do\r\n");
-				#endif
-						return true;
-					}
-				}
-			}
-		}
-        currProtectorCfg.shortDelay.heatIncEvts |= PHASE_C_BITMASK;
-	}
-	else
-	{
-		if(currProtectorCfg.shortDelay.isInverseTime)
+		if((uint32_t)pole->belowCnt+cycles >= shortDelayI2t.resetCnt)
 		{
-			if(Qc > 0)
-            {      
-			    Qc -= (double)AN_COUNT_PERIOD_DECAY;
-                if(Qc < 0)
-                {
-                    Qc = 0;
-                }
-            }
+			pole->q = 0;
 		}
 		else
 		{
-			Qc = 0;
-			if(isCountDownC)
-			{
-				disturbCntC++;
-				if(disturbCntC>=5)
-				{
-					if(countDownNumC <= delayTotalCountDownCnt)
-					{
-						countDownNumC++;
-					}
-					disturbCntC = 0;
-				}
-			}
-			else
-			{
-				disturbCntC = 0;
-			}
+			pole->belowCnt += cycles;
 		}
-        currProtectorCfg.shortDelay.heatIncEvts &= ~PHASE_C_BITMASK;
 	}
-
-	return false;
+	currProtectorCfg.shortDelay.heatIncEvts = 0;
 }
 
-
-
 void ShortDelayProtectorReInit(void)
 {
 	currProtectorCfg.shortDelay.gear = 600;
@@ -6,11 +6,10 @@
 #include "about.h"
 #include "breakerAdc.h"
 #include "memMgr.h"
+#include <string.h>
 
 
-static uint32_t overCntA = 0;
-static uint32_t overCntB = 0;
-static uint32_t overCntC = 0;
+static uint32_t overCnt[CURR_POLE_NUM];					/* ֵcurrPoleTab˳ */
 
 
 void ClrShortInstantProtectFlag(void)
@@ -31,20 +30,34 @@ uint16_t GetShortInstantGear(void)
 /* ˲ʱ */
 bool shortInstantProtector(const BreakerParaInfoDef *const breakerInfo)
 {
+#if SHORT_INSTANT_LOG
 	uint16_t Ir1 = GetLongDelayIr1();																	/* ȡǰʱΧ */
-	uint16_t actionAn = currProtectorCfg.shortInstant.gear*Ir1*SHORT_INSTANT_ACTION_PERCENT/100/100;	/* ·˲ʱλ*Ir1/100 = ǰ·˲ʱֵ */
-    uint16_t actionAnA = actionAn;
-    uint16_t actionAnB = actionAn;
-    uint16_t actionAnC = actionAn;
+	uint16_t actionAn = currProtectorCfg.shortInstant.gear*Ir1*SHORT_INSTANT_ACTION_PERCENT/100/100;	/* ڼ¼жʹֵ仯ʱľֵcurrPickupMs.shortInstant */
+#endif
+	const breakerParaDef *para = NULL;
 	uint32_t icwDelayCnt = 0;
 	bool actionFlag = false;
+	uint8_t fastMask = 0;
+	uint8_t i = 0;
 	
+	/* ģ⿴ŹжнͨѿȦ۱Ƿʹ(رպɵĿŹ100msʧЧ)Ѷ
+	 * SwitchOffѿУ嶨ʱϿȦѿڽʱɽежϿ
+	 * ־IsCurrQuiescentһֱΪǾֹŹжҲ´ */
+	if(IsAdcWatchdogTripped())
+	{
+		SwitchOffProtector(SWITCH_WARN_REASON_SHORT_INSTANT, PHASE_A_BITMASK|PHASE_B_BITMASK|PHASE_C_BITMASK);
+		ClrAdcWatchdogTripped();
+		memset(overCnt, 0, sizeof(overCnt));
+		currProtectorCfg.shortInstant.isProtected = true;
+		#if SHORT_INSTANT_LOG
+		log_t("ShortInstant - hardware trip by adc watchdog\r\n");
+		#endif
+		return true;
+	}
 	/* ˲δ */
 	if( !currProtectorCfg.shortInstant.isEnable )
 	{
-	    overCntA = 0;
-        overCntB = 0;
-        overCntC = 0;
+		memset(overCnt, 0, sizeof(overCnt));
         currProtectorCfg.shortInstant.heatIncEvts = 0;
 		return false;
 	}
@@ -53,86 +66,86 @@ bool shortInstantProtector(const BreakerParaInfoDef *const breakerInfo)
 	{	
 		return true;
 	}
-	/* A˲ʱж-ǰֵǷжֵ */
-	if(breakerInfo->ia.an >= actionAnA)
+#if SHORT_INSTANT_FAST_PICKUP
+	/* ڷֵȷϳֵʱʱֱӶ */
+	for(i=0; i<CURR_POLE_NUM; i++)
 	{
-		/* ݵǰicwDelayCntΪ0 */
-		icwDelayCnt = GetIcwDelayCnt(breakerInfo->ia.an);
-		overCntA++;											/* overCntAۼ */
-		if(overCntA>=SHORT_INSTANT_CNT_DEF+icwDelayCnt)		/* ĳһʱڼ> SHORT_INSTANT_CNT_DEF+icwDelayCnt  */
+		para = CURR_POLE_PARA(breakerInfo, i);
+		if((para->msFastQ8 >= currPickupMs.shortInstant[i]) && (0 == GetIcwDelayCnt(CountMsAn(para->idx, para->msFastQ8))))
 		{
-			actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_INSTANT, PHASE_A_BITMASK);	/* actionFlagΪTrue */
-			if(actionFlag)
-			{
-				overCntA = 0;
-				currProtectorCfg.shortInstant.isProtected = true;
-				#if SHORT_INSTANT_LOG
-				log_t("ShortInstant - switch off, iaAn: %d, actionAnA: %d\r\n", breakerInfo->ia.an, actionAnA);
-				#endif
-				return true;
-			}
+			fastMask |= currPoleTab[i].bitMask;
 		}
-        currProtectorCfg.shortInstant.heatIncEvts |= PHASE_A_BITMASK;
 	}
-	else
+	if(fastMask)
 	{
-		overCntA = 0;
-        currProtectorCfg.shortInstant.heatIncEvts &= ~PHASE_A_BITMASK;
-	}
-
-	if(breakerInfo->ib.an >= actionAnB)
-	{
-		icwDelayCnt = GetIcwDelayCnt(breakerInfo->ib.an);
-		overCntB++;
-		if(overCntB>=SHORT_INSTANT_CNT_DEF+icwDelayCnt)
+		actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_INSTANT, fastMask);
+		if(actionFlag)
 		{
-			actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_INSTANT, PHASE_B_BITMASK);
-			if(actionFlag)
-			{
-				overCntB = 0;
-				currProtectorCfg.shortInstant.isProtected = true;
-				#if SHORT_INSTANT_LOG
-				log_t("ShortInstant - switch off, ibAn: %d, actionAnB: %d\r\n", breakerInfo->ib.an, actionAnB);
-				#endif			
-				return true;
-			}
+			memset(overCnt, 0, sizeof(overCnt));
+			currProtectorCfg.shortInstant.isProtected = true;
+			#if SHORT_INSTANT_LOG
+			log_t("ShortInstant - fast pickup switch off, phase: 0x%x, actionAn: %d\r\n", fastMask, actionAn);
+			#endif
+			return true;
 		}
-        currProtectorCfg.shortInstant.heatIncEvts |= PHASE_B_BITMASK;
 	}
-	else
+#endif
+	/* жϵǰֵǷڶֵSHORT_INSTANT_CNT_DEF+icwDelayCntڼ */
+	for(i=0; i<CURR_POLE_NUM; i++)
 	{
-		overCntB = 0;
-        currProtectorCfg.shortInstant.heatIncEvts &= ~PHASE_B_BITMASK;
-	}
+		para = CURR_POLE_PARA(breakerInfo, i);
+		if(para->msQ8 < currPickupMs.shortInstant[i])
+		{
+			overCnt[i] = 0;
+			currProtectorCfg.shortInstant.heatIncEvts &= ~currPoleTab[i].bitMask;
+			continue;
+		}
 
-	if(breakerInfo->ic.an >= actionAnC)
-	{
-		icwDelayCnt = GetIcwDelayCnt(breakerInfo->ic.an);
-		overCntC++;
-		if(overCntC>=SHORT_INSTANT_CNT_DEF+icwDelayCnt)
+		/* ݵǰicwDelayCntΪ0 */
+		icwDelayCnt = GetIcwDelayCnt(GetParaAn(para));
+		overCnt[i]++;
+		if(overCnt[i]>=SHORT_INSTANT_CNT_DEF+icwDelayCnt)
 		{
-			actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_INSTANT, PHASE_C_BITMASK);	
+			actionFlag = SwitchOffProtector(SWITCH_WARN_REASON_SHORT_INSTANT, currPoleTab[i].bitMask);
 			if(actionFlag)
 			{
-				overCntC = 0;
+				overCnt[i] = 0;
 				currProtectorCfg.shortInstant.isProtected = true;
 				#if SHORT_INSTANT_LOG
-				log_t("ShortInstant - switch off, icAn: %d, actionAnC: %d\r\n", breakerInfo->ic.an, actionAnC);
-				#endif			
+				log_t("ShortInstant - switch off, pole: %d, an: %d, actionAn: %d\r\n", i, (int)GetParaAn(para), actionAn);
+				#endif
 				return true;
 			}
 		}
-        currProtectorCfg.shortInstant.heatIncEvts |= PHASE_C_BITMASK;
-	}
-	else
-	{
-		overCntC = 0;
-        currProtectorCfg.shortInstant.heatIncEvts &= ~PHASE_C_BITMASK;
+        currProtectorCfg.shortInstant.heatIncEvts |= currPoleTab[i].bitMask;
 	}
 
 	return false;
 }
 
+/*
+*********************************************************************************************************
+*	  : ShortInstantCool
+*	˵: ֹ·ڶֵ
+*	    : cycles
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void ShortInstantCool(uint16_t cycles)
+{
+	if(!currProtectorCfg.shortInstant.isEnable)
+	{
+		memset(overCnt, 0, sizeof(overCnt));
+        currProtectorCfg.shortInstant.heatIncEvts = 0;
+		return;
+	}
+	if(currProtectorCfg.shortInstant.isProtected)
+	{
+		return;
+	}
+	memset(overCnt, 0, sizeof(overCnt));
+	currProtectorCfg.shortInstant.heatIncEvts = 0;
+}
 
 void ShortInstantProtectorReInit(void)
 {
@@ -141,6 +154,54 @@ void ShortInstantProtectorReInit(void)
 }
 
 
+/*
+*********************************************************************************************************
+*	  : ShortInstantHwTripFresh
+*	˵: ɵǰ·˲ʱֵIr3ADCֵֵģ⿴Źֵ๲һֵȡСֵ
+*			  ADCʱرӲѿۣ˲ʱ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void ShortInstantHwTripFresh(void)
+{
+#if SHORT_INSTANT_HW_TRIP
+	static uint16_t actionAnPre = 0;
+	static bool isEnablePre = false;
+	uint16_t Ir1 = GetLongDelayIr1();
+	uint16_t actionAn = currProtectorCfg.shortInstant.gear*Ir1*SHORT_INSTANT_ACTION_PERCENT/100/100;
+	bool isEnable = currProtectorCfg.shortInstant.isEnable;
+	float an = (float)actionAn*SHORT_INSTANT_HW_MARGIN_PERCENT/100;
+	float rawRms = 0;
+	uint32_t high = 0;
+
+	/* ֵδ仯ʱ» */
+	if((actionAn == actionAnPre) && (isEnable == isEnablePre))
+	{
+		return;
+	}
+	actionAnPre = actionAn;
+	isEnablePre = isEnable;
+
+	rawRms = CountAnRawRms(IA_IDX, an);
+	if(CountAnRawRms(IB_IDX, an) < rawRms)
+	{
+		rawRms = CountAnRawRms(IB_IDX, an);
+	}
+	if(CountAnRawRms(IC_IDX, an) < rawRms)
+	{
+		rawRms = CountAnRawRms(IC_IDX, an);
+	}
+	high = (uint32_t)(rawRms*SHORT_INSTANT_HW_CREST_Q8) >> 8;
+	if(high > 4095)
+	{
+		high = 4095;
+	}
+
+	AdcWatchdogConfig(isEnable && (high < 4095), (uint16_t)high);
+#endif
+}
+
 /* ˲ʱ */
 bool ShortInstantHandler(const BreakerParaInfoDef *const breakerInfo)
 {
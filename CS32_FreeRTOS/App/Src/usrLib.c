@@ -44,23 +44,238 @@ uint32_t bcd2int(uint8_t *bcd, uint8_t len, bool isBig)
 }
 
 
-/* ֵ */
-float sqrSumAverSqrt(uint32_t *data, uint32_t len)
+/* ƽ(ȡ)λ̣޳FPUCortex-M0 */
+uint32_t SqrtU32(uint32_t val)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;						/* valߵ4 */
+
+	while(bit > val)
+	{
+		bit >>= 2;
+	}
+
+	while(bit != 0)
+	{
+		if(val >= root + bit)
+		{
+			val -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return root;
+}
+
+/* atan(i/ATAN_TAB_N)i = 0~ATAN_TAB_Nλ0.1ȣQ4 */
+static const uint16_t atanTabQ4[ATAN_TAB_N+1] = {
+	0, 143, 286, 429, 572, 715, 857, 999, 1140, 1281, 1421, 1560, 1699, 1837, 1974, 2110,
+	2246, 2380, 2513, 2646, 2777, 2907, 3035, 3163, 3289, 3414, 3538, 3660, 3781, 3900, 4018, 4135,
+	4250, 4364, 4477, 4588, 4697, 4805, 4912, 5017, 5121, 5223, 5324, 5423, 5521, 5618, 5713, 5807,
+	5899, 5990, 6080, 6168, 6255, 6341, 6425, 6508, 6590, 6670, 6750, 6828, 6904, 6980, 7054, 7128,
+	7200};
+
+/* ޷У(x,y)ĽǶ[0,360)ȣλ0.1ȣQ4(0~57599)|x||y|С2^16
+ * ˷Բ㵽[0,45]ȣСϴ֮(Q15)ԲֵԼ0.01 */
+uint32_t Atan2X10Q4(int32_t y, int32_t x)
+{
+	uint32_t ax = (x < 0) ? -x : x;
+	uint32_t ay = (y < 0) ? -y : y;
+	uint32_t t = 0;
+	uint32_t idx = 0;
+	uint32_t angle = 0;
+
+	if((0 == ax) && (0 == ay))
+	{
+		return 0;
+	}
+
+	t = (ay <= ax) ? ((ay << 15) / ax) : ((ax << 15) / ay);
+	idx = t >> (15 - ATAN_TAB_BITS);
+	angle = atanTabQ4[idx];
+	if(idx < ATAN_TAB_N)
+	{
+		angle += ((atanTabQ4[idx+1] - atanTabQ4[idx]) * (t & ((1 << (15 - ATAN_TAB_BITS)) - 1))) >> (15 - ATAN_TAB_BITS);
+	}
+
+	if(ay > ax)
+	{
+		angle = 900*16 - angle;
+	}
+	if(x < 0)
+	{
+		angle = 1800*16 - angle;
+	}
+	if((y < 0) && (0 != angle))
+	{
+		angle = 3600*16 - angle;
+	}
+
+	return angle;
+}
+
+/* αۼӺ͡ƽͼ/Сֵͳƣlen12λֵƽͲ32λ(len<=256)
+ * strideΪֵļֱӱDMA[][ͨ]ŵĻ */
+void CountSumStat(const int16_t *data, uint16_t len, uint16_t stride, SumStatDef *stat)
 {
 	uint32_t sum = 0;
+	uint32_t sqrSum = 0;
+	uint32_t max = 0;
+	uint32_t min = UINT32_MAX;
+	uint32_t val = 0;
+	uint16_t i = 0;
+
+	for(i=0; i<len; i++)
+	{
+		val = (uint16_t)*data;
+		data += stride;
+		sum += val;
+		sqrSum += val*val;							/* sqrSum:ƽۻ */
+		if(val > max)
+		{
+			max = val;
+		}
+		if(val < min)
+		{
+			min = val;
+		}
+	}
+
+	stat->sum = sum;
+	stat->sqrSum = sqrSum;
+	stat->max = (uint16_t)max;
+	stat->min = (uint16_t)min;
+}
+
+/* GoertzelƵ s[n] = x[n] + coeff*s[n-1] - s[n-2]coeff = 2cos(2k/N)Q14
+ * ״̬ñ棬ɷֶ(DMAǰ֡)ͬһڵĲֵstrideͬCountSumStat
+ * coeff*ssĸߵλˣ|s|<2^24ʱȫ32λ㣬64λ˷ */
+void GoertzelQ14(const int16_t *data, uint16_t len, uint16_t stride, int32_t coeffQ14, GoertzelStateDef *state)
+{
+	int32_t s0 = 0;
+	int32_t s1 = state->s1;
+	int32_t s2 = state->s2;
 	uint16_t i = 0;
-	float aver = 0;
-	float sqrtAver = 0;
 
 	for(i=0; i<len; i++)
 	{
-		sum += data[i]*data[i];						/* sum:ƽۻ */
+		s0 = (uint16_t)*data + coeffQ14*(s1 >> 14) + ((coeffQ14*(s1 & 0x3FFF)) >> 14) - s2;
+		data += stride;
+		s2 = s1;
+		s1 = s0;
 	}
 
-	aver = ((float)sum) / ((float)len);				/* ƽͳݸ */
+	state->s1 = s1;
+	state->s2 = s2;
+}
+
+/* sin(2k/FFT_R4_MAX_N)Q15cosȡsinǰ1/4ڵֵ */
+static const int16_t fftSinQ15[FFT_R4_MAX_N] = {
+	0, 3212, 6393, 9512, 12539, 15446, 18204, 20787, 23170, 25329, 27245, 28898, 30273, 31356, 32137, 32609,
+	32767, 32609, 32137, 31356, 30273, 28898, 27245, 25329, 23170, 20787, 18204, 15446, 12539, 9512, 6393, 3212,
+	0, -3212, -6393, -9512, -12539, -15446, -18204, -20787, -23170, -25329, -27245, -28898, -30273, -31356, -32137, -32609,
+	-32767, -32609, -32137, -31356, -30273, -28898, -27245, -25329, -23170, -20787, -18204, -15446, -12539, -9512, -6393, -3212};
+
+/* 4ƵʳȡFFTԭλ㣬buf[ʵ,鲿]n(Q15)nΪ4ҲFFT_R4_MAX_N
+ * ÿν2λֹX(k)*1/nѰȻ˳ */
+void FftR4Q15(int16_t *buf, uint16_t n)
+{
+	int32_t ar, ai, br, bi, cr, ci, dr, di;
+	int32_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+	int32_t wr = 0;
+	int32_t wi = 0;
+	uint16_t twStep = FFT_R4_MAX_N/n;
+	uint16_t len = 0;
+	uint16_t quarter = 0;
+	uint16_t i = 0;
+	uint16_t j = 0;
+	uint16_t k = 0;
+	uint16_t m = 0;
+	uint16_t r = 0;
+	int16_t tmp = 0;
+
+	for(len=n; len>1; len>>=2)
+	{
+		quarter = len >> 2;
+		for(j=0; j<quarter; j++)
+		{
+			for(i=j; i<n; i+=len)
+			{
+				ar = buf[2*i];
+				ai = buf[2*i+1];
+				br = buf[2*(i+quarter)];
+				bi = buf[2*(i+quarter)+1];
+				cr = buf[2*(i+2*quarter)];
+				ci = buf[2*(i+2*quarter)+1];
+				dr = buf[2*(i+3*quarter)];
+				di = buf[2*(i+3*quarter)+1];
+
+				t0r = ar + cr;
+				t0i = ai + ci;
+				t1r = ar - cr;
+				t1i = ai - ci;
+				t2r = br + dr;
+				t2i = bi + di;
+				t3r = br - dr;
+				t3i = bi - di;
+
+				buf[2*i]   = (int16_t)((t0r + t2r) >> 2);
+				buf[2*i+1] = (int16_t)((t0i + t2i) >> 2);
+				for(m=1; m<4; m++)
+				{
+					if(1 == m)
+					{
+						ar = t1r + t3i;					/* y1 = t1 - j*t3 */
+						ai = t1i - t3r;
+					}
+					else if(2 == m)
+					{
+						ar = t0r - t2r;					/* y2 = t0 - t2 */
+						ai = t0i - t2i;
+					}
+					else
+					{
+						ar = t1r - t3i;					/* y3 = t1 + j*t3 */
+						ai = t1i + t3r;
+					}
+					ar >>= 2;
+					ai >>= 2;
+
+					/* ת W^(m*j) = cos - j*sin */
+					k = (uint16_t)(m*j*twStep);
+					wr = fftSinQ15[(k + FFT_R4_MAX_N/4) & (FFT_R4_MAX_N-1)];
+					wi = fftSinQ15[k];
+					buf[2*(i+m*quarter)]   = (int16_t)((ar*wr + ai*wi) >> 15);
+					buf[2*(i+m*quarter)+1] = (int16_t)((ai*wr - ar*wi) >> 15);
+				}
+			}
+		}
+		twStep <<= 2;
+	}
 
-	sqrtAver = sqrt(aver);							/* sqrt()⺯averƽֵ */					
-	return sqrtAver;
+	/* 4λ򣬻ָȻ˳ */
+	for(i=0; i<n; i++)
+	{
+		r = 0;
+		for(j=1, k=i; j<n; j<<=2, k>>=2)
+		{
+			r = (r << 2) | (k & 3);
+		}
+		if(r > i)
+		{
+			tmp = buf[2*i];
+			buf[2*i] = buf[2*r];
+			buf[2*r] = tmp;
+			tmp = buf[2*i+1];
+			buf[2*i+1] = buf[2*r+1];
+			buf[2*r+1] = tmp;
+		}
+	}
 }
 
 uint32_t CountMax(uint32_t *data, uint32_t len)
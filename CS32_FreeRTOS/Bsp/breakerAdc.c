@@ -7,11 +7,25 @@
 *********************************************************************************************************
 */
 
-#define NPT								32		//64					/* ÿ20msڣADCͨĲ */
 #define DC_VOL							100
 #define A   							330
-#define FS								(PHASE_FREQ*NPT)	
-#define ADC_SAMPLE_POINTS				(NPT/PHASE_PERIOD_WINDOW_DIV)
+#define ADC_SAMPLE_POINTS				(NPT/PHASE_PERIOD_WINDOW_DIV)	/* ÿDMA֡Ĳ */
+
+#define ADC_FAST_CHANLS					(ADC_CONV_CHANNEL_7 | ADC_CONV_CHANNEL_8 | ADC_CONV_CHANNEL_9)
+#define ADC_SLOW_CHANLS					(ADC_CONV_CHANNEL_0 | ADC_CONV_CHANNEL_1 | ADC_CONV_CHANNEL_2 | ADC_CONV_CHANNEL_3 | \
+										 ADC_CONV_CHANNEL_4 | ADC_CONV_CHANNEL_5 | ADC_CONV_CHANNEL_6)
+#define ADC_SLOW_SCAN_DIV				(PHASE_FREQ/ADC_SLOW_SCAN_FREQ)	/* ÿٸƵɨһεͨ */
+#define ADC_SLOW_SCAN_TIMEOUT			2000	/* ͨתȴѯ */
+
+#define ADC_AWD_CONFIRM_CNT				3		/* ģ⿴Źȷϣһ֡ʱڲͬԽ޵Ĵ */
+#define ADC_RAW_MAX						4095
+
+/* RAMԤ㣺ԭ10ͨ*32DMA(640ֽ) */
+#define ADC_SAMPLE_RAM_BUDGET			640
+
+#if (2 != PHASE_PERIOD_WINDOW_DIV)
+#error "ADC DMA sliding window relies on half/complete transfer interrupts, PHASE_PERIOD_WINDOW_DIV must be 2"
+#endif
 
 #define CURR_MODE_SMALL_THRESHOLD		95
 #define CURR_MODE_BIG_THRESHOLD			105
@@ -19,23 +33,74 @@
 
 #define IN_MODE_THRESHOLD				150
 
+
+/* ҷֵƣ1/8Ƶڵȥֱֵ x0=Asin()x1=Asin(+/4)
+ * A^2 = (x0^2+x1^2-2x0x1cos(/4))/sin^2(/4) = 2(x0^2+x1^2) - 22x0x1 */
+#define AMP_EST_LAG						(NPT/8)	/* Լ8㣬2.5ms */
+#define AMP_EST_2SQRT2_Q6				181		/* 22 = 181/64 */
+#define AMP_EST_CONFIRM_CNT				3		/* 3ֵż룬Ƶ */
+
+#if CURR_SAMPLE_DC_REMOVE
+#define FFT_CALIB_AN(para)				((para).acAn)
+#else
+#define FFT_CALIB_AN(para)				((para).rmsAn)
+#endif
+#define AMP_EST_MS_SHIFT				(2*RMS_FRAC_BITS-1)	/* Ҿֵ = ֵ^2/2ΪQ8 */
+#define AN_RAW_MS_NONE					0xFFFFFFFFUL		/* ֵADCֵ̣޷ﵽ */
+
+STATIC_ASSERT(AMP_EST_LAG < NPT/PHASE_PERIOD_WINDOW_DIV, amp_est_lag_in_half);
+
+/* GoertzelгƵ㣺FFT_HARM_NUMгcoeff = 2cos(2k/NPT)(Q14)
+ * ÿÿƵԼʮָ3*5Ƶ*64ÿԼ1.5ʱڣ48MHzԼ0.3msHRC 8MHzԼ2ms
+ * 20msڣʵʱadcFrameStat.harmCycles */
+#define HARM_BIN_NUM					(FFT_HARM_NUM+1)
+#define HARM_FUND_MIN_Q4				(10<<RMS_FRAC_BITS)	/* 10ֵʱλг */
+#define HARM_FN_Q4_Q9					181		/* Чֵ = |X(k)|*2/NPTQ4|X(k)|*2/4 = |X(k)|*181/512 */
+#define HARM_MAG_BITS					15		/* ʵ鲿Ƶ15λڣƽͲ32λ */
+#define HARM_MUL_Q14(s, c)				((c)*((s) >> 14) + (((c)*((s) & 0x3FFF)) >> 14))	/* s*c/2^14sĸߵλ𿪣32λ */
+
+STATIC_ASSERT(64 == NPT, harm_coeff_table_npt_64);
+
+/* Ƶʸ٣ջTIM1ڣʹNPTǡøһƵ */
+#define FREQ_TRACK_AC_MIN				20		/* ȥֱֵ20ֵż */
+#define FREQ_TRACK_HYST					8		/* ز(ֵ)ھֵ-زżһ */
+#define FREQ_TRACK_AVG_CNT				10		/* ۼ10ڵƽֵһβ */
+#define FREQ_TRACK_PERIOD_MIN			(ADC_TRIG_TIM_CLK/(PHASE_FREQ_MAX*NPT) - 1)	/* TIM1ֵΧ */
+#define FREQ_TRACK_PERIOD_MAX			(ADC_TRIG_TIM_CLK/(PHASE_FREQ_MIN*NPT) - 1)
+
+STATIC_ASSERT(FREQ_TRACK_PERIOD_MAX <= 0xFFFF, freq_track_tim_16bit);
+
+/* FFT״̬IDLE/READYʱFFTREQ/FILLʱADC */
+#define FFT_SNAP_IDLE					0
+#define FFT_SNAP_REQ					1		/* FFT󣬵ȴһǰ֡ */
+#define FFT_SNAP_FILL					2		/* ǰ֡ѿȴ֡ */
+#define FFT_SNAP_READY					3		/* һѿȴFFT */
+#define FFT_SNAP_IN_SHIFT				3		/* 12λֵ3λΪQ15 */
+
+STATIC_ASSERT(NPT == FFT_R4_MAX_N, fft_snap_npt);
+STATIC_ASSERT(FFT_SPEC_NUM < NPT/2, fft_spec_below_nyquist);
+
 /*
 *********************************************************************************************************
 *	                                   
 *********************************************************************************************************
 */
-__IO int16_t adcVals[ADC_SAMPLE_POINTS][ADC_CHANLS_NUM] = {0};
+__IO int16_t adcVals[NPT][ADC_FAST_CHANLS_NUM] = {0};					/* ͨDMAѭǰ֡д룬ֱӰͨȡ */
+__IO uint16_t adcSlowVals[ADC_SLOW_CHANLS_NUM] = {0};					/* λԴͨһεɨֵ */
+static volatile uint8_t adcSlowSeq = 0;									/* ɨɼݴжֵ */
+static volatile uint32_t adcSlowScanFailCnt = 0;						/* ɨȴADCֹͣʱĴ */
 
-uint32_t adcValsFftIn[ADC_CHANLS_NUM][NPT] = {0};						/* תʵʴADCԭʼֵ */
+STATIC_ASSERT(sizeof(adcVals) + sizeof(adcSlowVals) <= ADC_SAMPLE_RAM_BUDGET, adc_sample_ram_budget);
+STATIC_ASSERT(NPT <= 256, adc_sqr_sum_32bit);		/* 12λֵƽ32λ */
 
-uint32_t ButtonAdcValue0;												/* λADCԭʼֵ */
+uint32_t ButtonAdcValue0;												/* λADCƽֵ */
 uint32_t ButtonAdcValue1;
 uint32_t ButtonAdcValue2;
 uint32_t ButtonAdcValue3;
 uint32_t ButtonAdcValue4;
 uint32_t ButtonAdcValue5;	
 
-uint8_t S1_VAL;															/* λʵʼֵ */
+uint8_t S1_VAL;															/* λȷϵĵλֵ */
 uint8_t S2_VAL;
 uint8_t S3_VAL;
 uint8_t S4_VAL;
@@ -48,12 +113,93 @@ BreakerParaInfoDef	breakerParaInfo;
 
 volatile uint8_t ADC_DMA_TRANSFER = 0;									/* DMA1жϱ־λ */
 
+static volatile uint8_t adcDmaHalfIdx = ADC_DMA_HALF_SECOND;				/* һɴDMA֡ */
+static volatile AdcDmaHalfDef adcDmaHalf[PHASE_PERIOD_WINDOW_DIV];		/* ƹһ֡֡żǱ־ */
+static volatile uint32_t adcDmaFrameSeq = 0;							/* DMAɴİ֡жۼ */
+static uint32_t adcFrameUs = 0;											/* ڴİ֡ʱ(us) */
+static AdcFrameStatDef adcFrameStat;									/* ֡ͳ */
+static uint32_t adcEvalSeq = 0;											/* һͱжϵİ֡ */
+#if ADC_PROBE_EN
+static AdcProbeDef adcProbe[ADC_PROBE_NUM];								/* ׶μʱͳ */
+static uint32_t adcProbeFrameStamp = 0;									/* ֡ʼʱ */
+static uint32_t adcProbeLapStamp = 0;									/* һ̽ʱ */
+#endif
+static SumStatDef iabcHalfStat[IABC_PHASE_NUM][PHASE_PERIOD_WINDOW_DIV];	/* ֡ۼӺ/ƽ/ֵ֡ϳһ */
+
+typedef struct
+{
+	int16_t hist[AMP_EST_LAG];			/* һ֡ĩβAMP_EST_LAGȥֱֵ */
+	uint16_t ampPre[AMP_EST_CONFIRM_CNT-1];	/* ֵƣȷ */
+	uint32_t seq;						/* ʷ֡ţʱʷЧ */
+}AmpEstDef;
+
+static AmpEstDef iabcAmpEst[IABC_PHASE_NUM];							/* ڷֵ״̬ */
+
+static const int32_t harmCoeffQ14[HARM_BIN_NUM] = {32610, 32138, 31357, 28899, 25330};	/* k=1,2,3,5,7 */
+static const int32_t harmCosQ14[HARM_BIN_NUM] = {16305, 16069, 15679, 14449, 12665};	/* cos(2k/NPT)Q14 */
+static const int32_t harmSinQ14[HARM_BIN_NUM] = {1606, 3196, 4756, 7723, 10394};		/* sin(2k/NPT)Q14 */
+static GoertzelStateDef iabcHarmState[IABC_PHASE_NUM][HARM_BIN_NUM];	/* Ƶ״̬ǰ֡ */
+static uint32_t harmSeq = 0;											/* ǰ֡֡ */
+static uint8_t harmIsValid = 0;										/* ǰ֡δ */
+
+typedef struct
+{
+	uint32_t lastPos;					/* һλ(ţQ8) */
+	uint32_t periodSum;					/* ۼƵڳ֮(㣬Q8) */
+	uint32_t seq;						/* һİ֡ */
+	int16_t lastVal;					/* һ֡һֵ */
+	uint8_t phase;						/* ࣺ0-A1-B2-C */
+	uint8_t isArmed;					/* ѵھֵ-زɼ */
+	uint8_t hasPos;						/* lastPosЧ */
+	uint8_t periodCnt;					/* ۼƵ */
+}FreqTrackDef;
+
+static FreqTrackDef freqTrack;											/* Ƶʸ״̬ */
+uint16_t phaseFreq = PHASE_FREQ;										/* ٵĵƵ(Hz)ʱ£AN_COUNT_FREQÿֱ֡Ӷȡ */
+
+typedef struct
+{
+	int16_t buf[2*NPT];					/* һڵĸգ[ʵ,鲿]FFTԭλ */
+	uint32_t seq;						/* ǰ֡֡ */
+	volatile uint8_t state;				/* FFT_SNAP_xxx */
+	uint8_t stateNext;					/* ֡״̬ȷδǺЧ */
+	uint8_t phase;						/* ࣺ0-A1-B2-C */
+}FftSnapDef;
+
+static FftSnapDef fftSnap;												/* ̨FFTڿ */
+
+static volatile uint8_t adcAwdIsEnable = 0;								/* ģ⿴Źѿʹ */
+static volatile uint16_t adcAwdHigh = ADC_RAW_MAX;						/* ģ⿴Źֵ(ADCֵ) */
+static volatile uint8_t adcAwdCfgPending = 0;							/* Źôд룬ADCֹͣʱЧ */
+static volatile uint8_t adcAwdTripped = 0;								/* Źѿ */
+static uint8_t adcAwdCnt = 0;											/* Խȷϼ */
+static uint32_t adcAwdFirstRow = 0;										/* ȷϴ׸Խ޲ */
+static uint32_t adcAwdLastRow = 0;										/* һԽ޲ */
+
+typedef struct
+{
+	uint16_t hist[BUTTON_NUM][BUTTON_AVER_NUM];	/* BUTTON_AVER_NUMɨֵ */
+	uint16_t averSum[BUTTON_NUM];		/* hist֮ͣƽֵ<<BUTTON_AVER_SHIFT */
+	uint8_t histIdx;					/* histһɨֵλ */
+	uint8_t gear[BUTTON_NUM];			/* ȷϵλ */
+	uint8_t pending[BUTTON_NUM];		/* ȷϵλ */
+	uint8_t settleCnt[BUTTON_NUM];		/* ȷϵλѱֵɨ */
+	uint8_t slowSeq;					/* ѽĵɨ */
+	uint16_t chgSeq;					/* λȷϱ仯0Ϊδ */
+}ButtonDecodeDef;
+
+static ButtonDecodeDef buttonDecode;									/* λλ״̬ */
+
+STATIC_ASSERT(BUTTON_SETTLE_SCANS > BUTTON_AVER_NUM, button_settle_over_aver);
+
 /*
 *********************************************************************************************************
 *	                                   
 *********************************************************************************************************
 */
 //void cr4_fft_64_stm32(void *pssOUT, void *pssIN, uint16_t Nbin);
+static void AdcSlowChanlsScan(void);
+static void ButtonDecode(void);
 
 
 /*
@@ -78,6 +224,7 @@ void StartAdcInit(void)
 	uint32_t ADC_CALB = 0;
     adc_config_t   adc_config_struct;
     gpio_config_t  gpio_config_struct;
+	nvic_config_t  nvic_config_struct;
 	
 	/* 	CHANNEL | GPIO	|	  ADC Channel	  | 					|	ADCͨתʱ䣺tCONV = ʱ + ( 12.5 * ADCʱ )   ǰADCʱΪ14MHz	
 	 *		0		PA0				ADC_IN0			 λͨ0			(28.5 + 12.5) * 1/14M = 2.9uS
@@ -122,14 +269,7 @@ void StartAdcInit(void)
     adc_config_struct.scan_direction = ADC_CONV_SEQ_DIR_UPWARD;					/* ǰɨ:ɨͨ0ͨ18 */
     adc_init(ADC1, &adc_config_struct); 															  /* ʼADC1 */
 
-    /* ADC1ͨĲʱ */ 
-    adc_channel_config(ADC1, ADC_CONV_CHANNEL_0 , ADC_SAMPLE_TIMES_28_5); 
-    adc_channel_config(ADC1, ADC_CONV_CHANNEL_1 , ADC_SAMPLE_TIMES_28_5); 
-    adc_channel_config(ADC1, ADC_CONV_CHANNEL_2 , ADC_SAMPLE_TIMES_28_5); 
-    adc_channel_config(ADC1, ADC_CONV_CHANNEL_3 , ADC_SAMPLE_TIMES_28_5); 
-    adc_channel_config(ADC1, ADC_CONV_CHANNEL_4 , ADC_SAMPLE_TIMES_28_5); 
-    adc_channel_config(ADC1, ADC_CONV_CHANNEL_5 , ADC_SAMPLE_TIMES_28_5); 
-    adc_channel_config(ADC1, ADC_CONV_CHANNEL_6 , ADC_SAMPLE_TIMES_28_5); 
+    /* ADC1ͨĲʱ䣬ʱֻɨͨλԴͨAdcSlowChanlsScanɨ */ 
     adc_channel_config(ADC1, ADC_CONV_CHANNEL_7 , ADC_SAMPLE_TIMES_28_5); 
     adc_channel_config(ADC1, ADC_CONV_CHANNEL_8 , ADC_SAMPLE_TIMES_28_5); 
     adc_channel_config(ADC1, ADC_CONV_CHANNEL_9 , ADC_SAMPLE_TIMES_28_5); 	
@@ -149,6 +289,15 @@ void StartAdcInit(void)
 		printf("ADC calibration value = 0x%x \r\n",ADC_CALB);
 	}
 	
+	/* ģ⿴ŹȫѡֵͨͨʹڵɨADCֹͣʱд */
+	adc_watchdog_channel_mode_enable_ctrl(ADC1, DISABLE);
+	adc_watchdog_thresholds_set(ADC1, ADC_RAW_MAX, 0);
+	adc_interrupt_config(ADC1, ADC_INTR_WDEVT, ENABLE);
+	nvic_config_struct.nvic_IRQ_channel = IRQn_ADC1;
+	nvic_config_struct.nvic_channel_priority = 0;
+	nvic_config_struct.nvic_enable_flag = ENABLE;
+	nvic_init(&nvic_config_struct);
+
 	/* ʹADCDMADMAΪѭģʽ */                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                         
 	adc_dma_mode_set(ADC1, ADC_DMA_MODE_CIRCULAR); 
 
@@ -186,7 +335,7 @@ void StartAdcDmaInit(void)
 	dma_configStruct.peri_base_addr = (uint32_t)ADC1_OUTDAT_REG_ADDRESS;		/* Ĵַ */
 	dma_configStruct.mem_base_addr = (uint32_t)&adcVals[0][0];					/* ô洢ַ--(uint32_t)&adcVals[0][0];	 */
 	dma_configStruct.transfer_direct = DMA_TRANS_DIR_FROM_PERI;					/* ݴ䷽򣺴赽ڴ */			
-	dma_configStruct.buf_size = ADC_CHANLS_NUM*ADC_SAMPLE_POINTS;				/* ÿδݴС */
+	dma_configStruct.buf_size = ADC_FAST_CHANLS_NUM*NPT;						/* ÿδݴСһ */
 	dma_configStruct.peri_inc_flag = DMA_PERI_INC_DISABLE;						/* ַ */
 	dma_configStruct.mem_inc_flag = DMA_MEM_INC_ENABLE;							/* ַ */
 	dma_configStruct.peri_data_width = DMA_PERI_DATA_WIDTH_HALFWORD;			/* ݿ */
@@ -197,7 +346,7 @@ void StartAdcDmaInit(void)
 	dma_init(DMA1_CHANNEL1, &dma_configStruct);									/* дDMAƽṹ */
 
 	
-	dma_interrupt_set(DMA1_CHANNEL1,DMA_INT_CONFIG_CMP,ENABLE);					/* ʹDMAжϣ ж*/
+	dma_interrupt_set(DMA1_CHANNEL1,DMA_INT_CONFIG_HLF|DMA_INT_CONFIG_CMP,ENABLE);	/* ʹDMA봫估ж */
 	
 	nvic_config_struct.nvic_IRQ_channel = IRQn_DMA1_CHANNEL1;					/* ʹDMA1 channel1 IRQ Channel */
 	nvic_config_struct.nvic_channel_priority = 0;
@@ -220,6 +369,9 @@ void StartAdcDmaInit(void)
 */
 void StartAdcConvert(void)
 {
+	/* ɨһελԴ֤ͨ׸ڵıЧ */
+	AdcSlowChanlsScan();
+
 	/* ADCת */
     adc_conversion_start(ADC1);
 	
@@ -246,15 +398,99 @@ void StopAdcConvert(void)
 
 
 
-void CountFFTParas(uint32_t *fftIn, FFTParasDef *para)
+/*
+*********************************************************************************************************
+*	  : CountFFTParasFromStat
+*	˵: һ(NPT)ۼӺ/ƽ/ֱֵȥֱֱֵֵֵȫ
+*	    : const SumStatDef *stat һڵĲͳֵ
+*			   FFTParasDef *para      
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void CountFFTParasFromStat(const SumStatDef *stat, FFTParasDef *para)
+{
+	uint32_t dcQ4 = 0;
+	uint32_t sqrAverQ8 = 0;
+	uint32_t dcSqrQ8 = 0;
+	uint32_t dc = 0;
+
+	/* 12λֵֵ(Q4)65520ֵ(Q8)4095*4095*25632λ */
+	dcQ4 = (stat->sum << RMS_FRAC_BITS) / NPT;
+	sqrAverQ8 = stat->sqrSum * ((1<<(2*RMS_FRAC_BITS))/NPT);			/* NPTΪ2Ҳ256 */
+	dcSqrQ8 = dcQ4*dcQ4;
+	if(dcSqrQ8 > sqrAverQ8)
+	{
+		dcSqrQ8 = sqrAverQ8;
+	}
+	dc = (dcQ4 + (1<<(RMS_FRAC_BITS-1))) >> RMS_FRAC_BITS;
+
+	para->dcAn = (float)dcQ4 / (1<<RMS_FRAC_BITS);
+#if CURR_SAMPLE_DC_REMOVE
+	para->msQ8 = sqrAverQ8 - dcSqrQ8;
+#else
+	para->msQ8 = sqrAverQ8;
+#endif
+	para->acAn = (float)SqrtU32(sqrAverQ8 - dcSqrQ8) / (1<<RMS_FRAC_BITS);
+	para->rmsAn = (float)SqrtU32(sqrAverQ8) / (1<<RMS_FRAC_BITS);
+	para->maxVal = stat->max;
+	para->minVal = stat->min;
+	para->posPeak = (stat->max > dc) ? (stat->max - dc) : 0;
+	para->negPeak = (dc > stat->min) ? (dc - stat->min) : 0;
+}
+
+/*
+*********************************************************************************************************
+*	  : CountFFTParas_I
+*	˵: αһڲֱȥֱֱֵֵֵ
+*	    : const int16_t *samples ͨһֵַ
+*			   uint16_t stride        ڲֵļDMAΪͨ
+*			   FFTParasDef *para      
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void CountFFTParas_I(const int16_t *samples, uint16_t stride, FFTParasDef *para)
+{
+	SumStatDef stat;
+
+	CountSumStat(samples, NPT, stride, &stat);
+	CountFFTParasFromStat(&stat, para);
+}
+
+/*
+*********************************************************************************************************
+*	  : CountFFTParasSliding
+*	˵: ڻڼ㣺ɵİ֡ͳֵһ֡ͳֵϳںֵ
+*			  һδİ֡(֡򸲸Ƕ)ʱһ֡ѹڣԱ֡棬2֡
+*	    : const SumStatDef *fresh ɵİ֡ͳֵ
+*			   SumStatDef *halfStat   ֡ͳֵ
+*			   uint8_t half           ɵİ֡
+*			   bool isGap             һδİ֡
+*			   FFTParasDef *para      
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void CountFFTParasSliding(const SumStatDef *fresh, SumStatDef *halfStat, uint8_t half, bool isGap, FFTParasDef *para)
 {
-	para->acAn = sqrSumAverSqrt(fftIn, NPT);	
+	const SumStatDef *other = &halfStat[half^1];
+	SumStatDef stat;
+
+	halfStat[half] = *fresh;
+	if(isGap)
+	{
+		halfStat[half^1] = *fresh;
+	}
+
+	stat.sum = halfStat[half].sum + other->sum;
+	stat.sqrSum = halfStat[half].sqrSum + other->sqrSum;
+	stat.max = (halfStat[half].max > other->max) ? halfStat[half].max : other->max;
+	stat.min = (halfStat[half].min < other->min) ? halfStat[half].min : other->min;
+
+	CountFFTParasFromStat(&stat, para);
 }
 
-void CountFFTParas_I(uint32_t *fftIn, FFTParasDef *para)
+void CountFFTParas(const int16_t *samples, uint16_t stride, FFTParasDef *para)
 {
-	/* ֵ㣬fftInݵַ NPTݸ */
-	para->acAn = sqrSumAverSqrt(fftIn, NPT);
+	CountFFTParas_I(samples, stride, para);
 }
 
 /* úԴδʹ */
@@ -297,10 +533,82 @@ float Linearfitting(float fftAn, CalibInfoDef *para)
 
 
 
+/* ͺУ׼ߣCALIB_KNEEΪУ׼(lincalibMeterEx)ΪCALIB_CURVE_HIGH
+ * οУ׼ұͬһ */
+#define CALIB_LINE(x, x1, y1, x2, y2)	((y2) - ((x2)-(x))*((y2)-(y1))/((x2)-(x1)))
+
+#if (DEV_TYPE_250A == DEV_TYPE)
+#define CALIB_KNEE						619
+#define CALIB_JOIN_LOW					1220.0f		/* 3000~3500Aֱ߶νӣ0.5A */
+#define CALIB_JOIN_HIGH					1265.59f	/* ֱ߶νӣϵ㴦ͬΪ3500A */
+#define CALIB_CURVE_HIGH(x)				(((x) > CALIB_JOIN_HIGH) ? CALIB_LINE(x, 1265.59f, 3500, 1276.989f, 4000)	\
+										: ((x) > CALIB_JOIN_LOW) ? CALIB_LINE(x, 1220.622f, 3000, 1265.59f, 3500)	\
+										: (0.0000044649f*(x)*(x)*(x) - 0.0083945596f*(x)*(x) + 7.0288443712f*(x) - 1194.8188753816f))
+#define CALIB_CURVE_JOINS				CALIB_LUT_KNOT(CALIB_JOIN_LOW), CALIB_LUT_KNOT(CALIB_JOIN_HIGH)
+#elif (DEV_TYPE_400A == DEV_TYPE)
+#define CALIB_KNEE						380
+#define CALIB_CURVE_HIGH(x)				(0.0000128810f*(x)*(x)*(x) - 0.0225955140f*(x)*(x) + 15.66945201f*(x) - 2431.206437f)
+#elif (DEV_TYPE_630A == DEV_TYPE)
+#define CALIB_KNEE						230
+#define CALIB_CURVE_HIGH(x)				(0.0000200147f*(x)*(x)*(x) - 0.017477739f*(x)*(x) + 10.18431671f*(x) - 711.9305831f)
+#else
+#define CALIB_KNEE						0		/* У׼ߣȫֱADCֵ */
+#define CALIB_CURVE_HIGH(x)				(x)
+#endif
+
+#if (DEV_TYPE_250A == DEV_TYPE) || (DEV_TYPE_400A == DEV_TYPE) || (DEV_TYPE_630A == DEV_TYPE)
+#define CALIB_HAS_CURVE					1
+#define CALIB_CURVE(x, lin)				(((x) > CALIB_KNEE) ? CALIB_CURVE_HIGH(x) : (lin))
+#else
+#define CALIB_HAS_CURVE					0
+#define CALIB_CURVE(x, lin)				(x)
+#endif
+
+/* У׼ұADCֵ(Q4)2^CALIB_LUT_SHIFTȼȡ㣬CALIB_CURVE_HIGH㣬Flash
+ * ֵΪ(AQ4)޷[0, CALIB_LUT_AN_MAX]յµıֵΪӳֻڿյһֵ */
+#define CALIB_LUT_SHIFT					8		/* 2^8(Q4)16ֵ */
+#define CALIB_LUT_STEP					((float)(1<<CALIB_LUT_SHIFT)/(1<<RMS_FRAC_BITS))
+#define CALIB_LUT_NUM					((((ADC_RAW_MAX+1)<<RMS_FRAC_BITS)>>CALIB_LUT_SHIFT) + 1)
+#define CALIB_LUT_AN_MAX				65535.0f
+#define CALIB_AN_Q4(x)					((uint32_t)(((CALIB_CURVE_HIGH(x) < 0) ? 0	\
+											: (CALIB_CURVE_HIGH(x) > CALIB_LUT_AN_MAX) ? CALIB_LUT_AN_MAX	\
+											: CALIB_CURVE_HIGH(x)) * (1<<RMS_FRAC_BITS) + 0.5f))
+#define CALIB_LUT_Q4(i)					CALIB_AN_Q4((i)*CALIB_LUT_STEP)
+#define CALIB_LUT_4(i)					CALIB_LUT_Q4(i), CALIB_LUT_Q4((i)+1), CALIB_LUT_Q4((i)+2), CALIB_LUT_Q4((i)+3)
+#define CALIB_LUT_16(i)					CALIB_LUT_4(i), CALIB_LUT_4((i)+4), CALIB_LUT_4((i)+8), CALIB_LUT_4((i)+12)
+#define CALIB_LUT_64(i)					CALIB_LUT_16(i), CALIB_LUT_16((i)+16), CALIB_LUT_16((i)+32), CALIB_LUT_16((i)+48)
+#define CALIB_LUT_256(i)				CALIB_LUT_64(i), CALIB_LUT_64((i)+64), CALIB_LUT_64((i)+128), CALIB_LUT_64((i)+192)
+
+STATIC_ASSERT(257 == CALIB_LUT_NUM, calib_lut_num);
+
+static const uint32_t calibLutQ4[CALIB_LUT_NUM] = {CALIB_LUT_256(0), CALIB_LUT_Q4(256)};
+
+#ifdef CALIB_CURVE_JOINS
+/* ֶνӴбͻ(250Aͺ3500AԼ11A/ֵΪԼ44A/ֵ)ȼνӵֵ
+ * νӵڵQ4ֵһڵ㣬νӵı񰴽ڵֶβֵֵһ */
+typedef struct
+{
+	uint32_t rawQ4;						/* ڵADCֵ(Q4) */
+	uint32_t anQ4;						/* ڵֵ(AQ4) */
+}CalibKnotDef;
+
+#define CALIB_KNOT_RAW_Q4(x)			((uint32_t)((x)*(1<<RMS_FRAC_BITS)))
+#define CALIB_KNOT(q)					{(q), CALIB_AN_Q4((float)(q)/(1<<RMS_FRAC_BITS))}
+#define CALIB_LUT_KNOT(x)				CALIB_KNOT(CALIB_KNOT_RAW_Q4(x)), CALIB_KNOT(CALIB_KNOT_RAW_Q4(x) + 1)
+
+static const CalibKnotDef calibKnot[] = {CALIB_CURVE_JOINS};
+
+#define CALIB_KNOT_NUM					(sizeof(calibKnot)/sizeof(calibKnot[0]))
+#endif
+
+/* СУ׼ĶϵcalibMeterExCalibLutInitм㣺an(Q4) = (rawQ4*k(Q16) >> 16) + b(Q4) */
+static int32_t calibLinKQ16[IABC_PHASE_NUM];
+static int32_t calibLinBQ4[IABC_PHASE_NUM];
+
 /*
 *********************************************************************************************************
 *	  : countbreakerParaAn
-*	˵: ADCɼתľֵʵĵֵ
+*	˵: ADCɼתľֵʵĵֵ(ο㣬У׼ұͬһ߶)
 *	    :  uint8_t idx          
 *			   float fftAn         
 *			   CalibInfoDef *para   
@@ -309,59 +617,8 @@ float Linearfitting(float fftAn, CalibInfoDef *para)
 */
 float countbreakerParaAn(uint8_t idx, float fftAn, CalibInfoDef *para)
 {
-	float an = fftAn;
-    float tmp = 0;
-    CalibInfoDef line;
-
-	#if (DEV_TYPE_250A == DEV_TYPE)
-    if(fftAn > 1265)
-    {
-        line.frist.An = 3500;
-        line.frist.fftAn = 1265.59f;
-        line.second.An = 4000;
-        line.second.fftAn = 1276.989f;
-        an = Linearfitting(fftAn, &line);
-    }
-    else if(fftAn > 1220)
-    {
-        line.frist.An = 3000;
-        line.frist.fftAn = 1220.622f;
-        line.second.An = 3500;
-        line.second.fftAn = 1265.59f;
-        an = Linearfitting(fftAn, &line);			
-    }
-    else if(fftAn > 619)
-    {
-        an = 0.0000044649f*fftAn*fftAn*fftAn - 0.0083945596f*fftAn*fftAn + 7.0288443712f*fftAn - 1194.8188753816f;
-    }
-    else
-    {
-        an = Linearfitting(fftAn, para);
-    }
-    
-	#elif (DEV_TYPE_400A == DEV_TYPE)
-    if(fftAn > 380)
-    {
-        an = 0.0000128810f*fftAn*fftAn*fftAn - 0.0225955140f*fftAn*fftAn + 15.66945201f*fftAn - 2431.206437f;
-    }
-    else
-    {
-        an = Linearfitting(fftAn, para);
-    } 
-
-	#elif (DEV_TYPE_630A == DEV_TYPE)
-    if(fftAn > 230)
-    {
-        an = 0.0000200147f*fftAn*fftAn*fftAn - 0.017477739f*fftAn*fftAn + 10.18431671f*fftAn - 711.9305831f;   
-    }
-    else
-    {
-        an = Linearfitting(fftAn, para);
-    } 
-	#else		
-		
-	#endif
-   
+	float an = CALIB_CURVE(fftAn, Linearfitting(fftAn, para));
+
 	if(an < 0)
 	{
 		an = 0;
@@ -370,213 +627,1406 @@ float countbreakerParaAn(uint8_t idx, float fftAn, CalibInfoDef *para)
 	return an;
 }
 
-static void IabcAnCount( void )
+/*
+*********************************************************************************************************
+*	  : CalibLutInit
+*	˵: calibMeterExСУ׼ĶϵУ׼仯µ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void CalibLutInit(void)
 {
-	/* AࣺAADCͨɼֵľֵֵ BreakerFft.ia.fftPara.acAn */
-	CountFFTParas_I(&adcValsFftIn[IA_IDX][0], &BreakerFft.ia.fftPara);
-	/* ֵۼӼ */
-	BreakerFft.ia.anSum += BreakerFft.ia.fftPara.acAn;
-	/* breakerParaInfo.ia.an ˲ΪĵǰֵCS32ֲܲҪ޸ */
-	breakerParaInfo.ia.an = countbreakerParaAn(IA_IDX, BreakerFft.ia.fftPara.acAn, &(calibMeterEx.ia));
-	/* ֵۼӼ */
-	breakerParaInfo.ia.anSum += breakerParaInfo.ia.an;
-	
-	/* IbL */
-	CountFFTParas_I(&adcValsFftIn[IB_IDX][0], &BreakerFft.ib.fftPara);
-	BreakerFft.ib.anSum += BreakerFft.ib.fftPara.acAn;
-	breakerParaInfo.ib.an = countbreakerParaAn(IB_IDX, BreakerFft.ib.fftPara.acAn, &(calibMeterEx.ib));
-	breakerParaInfo.ib.anSum += breakerParaInfo.ib.an;
-
-	/* IcL */
-	CountFFTParas_I(&adcValsFftIn[IC_IDX][0], &BreakerFft.ic.fftPara);
-	BreakerFft.ic.anSum += BreakerFft.ic.fftPara.acAn;
-	breakerParaInfo.ic.an = countbreakerParaAn(IC_IDX, BreakerFft.ic.fftPara.acAn, &(calibMeterEx.ic));
-	breakerParaInfo.ic.anSum += breakerParaInfo.ic.an;	
-}
-
+	const CalibInfoDef *para[IABC_PHASE_NUM] = {&calibMeterEx.ia, &calibMeterEx.ib, &calibMeterEx.ic};
+	float k = 0;
+	uint8_t i = 0;
 
-static void AnAverCount( void )
-{
-	/* periodIdx */
-	breakerParaInfo.periodIdx++;
-	
-	if(breakerParaInfo.periodIdx>=AN_AVER_COUNT) //PHASE_FREQ
+	for(i=0; i<IABC_PHASE_NUM; i++)
 	{
-	    portENTER_CRITICAL();
-		/* ԭʼֵƽֵ㣿 */
-		BreakerFft.ia.anAver = BreakerFft.ia.anSum/AN_AVER_COUNT;
-		BreakerFft.ib.anAver = BreakerFft.ib.anSum/AN_AVER_COUNT;
-		BreakerFft.ic.anAver = BreakerFft.ic.anSum/AN_AVER_COUNT;
-		/* ļֵƽֵ㣿 */
-		breakerParaInfo.ia.anAver = breakerParaInfo.ia.anSum/AN_AVER_COUNT;
-		breakerParaInfo.ib.anAver = breakerParaInfo.ib.anSum/AN_AVER_COUNT;
-		breakerParaInfo.ic.anAver = breakerParaInfo.ic.anSum/AN_AVER_COUNT;
-        portEXIT_CRITICAL();
-		/* ȫ㣬ȴһμ */
-		BreakerFft.ia.anSum = 0;
-		BreakerFft.ib.anSum = 0;
-		BreakerFft.ic.anSum = 0;
-
-		breakerParaInfo.ia.anSum = 0;
-		breakerParaInfo.ib.anSum = 0;
-		breakerParaInfo.ic.anSum = 0;
-		
-		breakerParaInfo.periodIdx = 0;
+		if(!CALIB_HAS_CURVE)
+		{
+			calibLinKQ16[i] = 65536;				/* յΪ0rawQ4Ϊ0ʱߴ˷֧ */
+			calibLinBQ4[i] = 0;
+			continue;
+		}
+		if(para[i]->second.fftAn == para[i]->frist.fftAn)
+		{
+			calibLinKQ16[i] = 0;					/* ͬLinearfittingУ׼غʱΪ0 */
+			calibLinBQ4[i] = 0;
+			continue;
+		}
+		k = (para[i]->second.An - para[i]->frist.An) / (para[i]->second.fftAn - para[i]->frist.fftAn);
+		calibLinKQ16[i] = (int32_t)(k*65536 + 0.5f);
+		calibLinBQ4[i] = (int32_t)((para[i]->second.An - para[i]->second.fftAn*k)*(1<<RMS_FRAC_BITS));
 	}
 }
 
-static void BreakerAdcHandler(void)
+/*
+*********************************************************************************************************
+*	  : CountCalibAnQ4
+*	˵: 㻻ֵյ°У׼ϵ㣬յУ׼ұԲֵ
+*			  зֶνӽڵʱڽڵֵμ㸡ζʽ
+*	    : uint8_t idx     IA_IDX/IB_IDX/IC_IDX
+*			   uint32_t rawQ4  ADCֵ(Q4)
+*	  ֵ: ֵ(AQ4)
+*********************************************************************************************************
+*/
+uint32_t CountCalibAnQ4(uint8_t idx, uint32_t rawQ4)
 {
-	uint16_t channel = 0;								/* ADCͨĿ */
-	uint16_t points = 0;								/* ÿڲ */
-	uint16_t offset = 0;
-				
-	
-#if BREAKER_ADC_LOG
-	static uint32_t sTick = 0;
-    sTick = xTaskGetTickCount();
+	uint8_t phase = (IA_IDX == idx) ? 0 : ((IB_IDX == idx) ? 1 : 2);
+	uint32_t i = rawQ4 >> CALIB_LUT_SHIFT;
+	uint32_t frac = rawQ4 & ((1<<CALIB_LUT_SHIFT) - 1);
+	int32_t anQ4 = 0;
+#ifdef CALIB_CURVE_JOINS
+	uint32_t lowRaw = 0;
+	uint32_t highRaw = 0;
+	int32_t lowAn = 0;
+	int32_t highAn = 0;
+	uint8_t k = 0;
 #endif
-	/* adcValsFftIn[channel][points]ΪתadcݵĴ洢ַСΪadcValsFftIn[9][64] */
-	for(channel = 0; channel < ADC_CHANLS_NUM; channel++)
-	{
-		#if (4==PHASE_PERIOD_WINDOW_DIV)
-			offset = NPT-ADC_SAMPLE_POINTS;
-			memmove(&adcValsFftIn[channel][0], &adcValsFftIn[channel][ADC_SAMPLE_POINTS], offset*sizeof(uint32_t) );
-		#else
-			offset = 0;
-		#endif
-		/* ADCԭʼֵת洢ʽ[][ͨ] -> [ͨ][] */
-		for(points = 0; points < ADC_SAMPLE_POINTS; points++)
+
+	if(rawQ4 <= (CALIB_KNEE << RMS_FRAC_BITS))
+	{
+		/* յ£rawQ4*kյ(Q4)*б(Q16)ͺžС2^31 */
+		anQ4 = (int32_t)(((int64_t)rawQ4*calibLinKQ16[phase]) >> 16) + calibLinBQ4[phase];
+	}
+	else if(i >= CALIB_LUT_NUM - 1)
+	{
+		anQ4 = (int32_t)calibLutQ4[CALIB_LUT_NUM - 1];
+	}
+	else
+	{
+		/* ڱֵ֮CALIB_LUT_AN_MAX(Q4)frac(<256)32λ */
+		anQ4 = (int32_t)(calibLutQ4[i] + (((calibLutQ4[i+1] - calibLutQ4[i])*frac) >> CALIB_LUT_SHIFT));
+#ifdef CALIB_CURVE_JOINS
+		lowRaw = i << CALIB_LUT_SHIFT;
+		highRaw = lowRaw + (1<<CALIB_LUT_SHIFT);
+		lowAn = (int32_t)calibLutQ4[i];
+		highAn = (int32_t)calibLutQ4[i+1];
+		for(k=0; k<CALIB_KNOT_NUM; k++)
+		{
+			if((calibKnot[k].rawQ4 <= lowRaw) || (calibKnot[k].rawQ4 >= highRaw))
+			{
+				continue;
+			}
+			if(calibKnot[k].rawQ4 <= rawQ4)
+			{
+				lowRaw = calibKnot[k].rawQ4;
+				lowAn = (int32_t)calibKnot[k].anQ4;
+			}
+			else
+			{
+				highRaw = calibKnot[k].rawQ4;
+				highAn = (int32_t)calibKnot[k].anQ4;
+				break;
+			}
+		}
+		if((highRaw - lowRaw) != (1<<CALIB_LUT_SHIFT))
 		{
-			adcValsFftIn[channel][points+offset] = adcVals[points][channel];
+			/* ڵı߳˻ͬϲ32λ */
+			anQ4 = lowAn + (highAn - lowAn)*(int32_t)(rawQ4 - lowRaw)/(int32_t)(highRaw - lowRaw);
 		}
+#endif
 	}
 
-	IabcAnCount();
-	AnAverCount();
-		
-	/* 洢λADCֵ */
-	ButtonAdcValue0 = adcValsFftIn[BUTTON_0_IDX][7];
-	ButtonAdcValue1 = adcValsFftIn[BUTTON_1_IDX][7];
-	ButtonAdcValue2 = adcValsFftIn[BUTTON_2_IDX][7];
-	ButtonAdcValue3 = adcValsFftIn[BUTTON_3_IDX][7];
-	ButtonAdcValue4 = adcValsFftIn[BUTTON_4_IDX][7];
-	ButtonAdcValue5 = adcValsFftIn[BUTTON_5_IDX][7];					
-	/* λֵλֵ */
-	S1_VAL = ButtonGearConvert(ButtonAdcValue0);
-	S2_VAL = ButtonGearConvert(ButtonAdcValue1);
-	S3_VAL = ButtonGearConvert(ButtonAdcValue2);
-	S4_VAL = ButtonGearConvert(ButtonAdcValue3);
-	S5_VAL = ButtonGearConvert(ButtonAdcValue4);
-	S6_VAL = ButtonGearConvert(ButtonAdcValue5);	
-	
-	#if BREAKER_ADC_LOG
-	sTick = xTaskGetTickCount() - sTick;
-	log_t("adc cplt : %lu ms, tick - %lu\r\n", sTick, xTaskGetTickCount());
-	#endif	
-
-	BreakerHandler(&breakerParaInfo);				/* BreakerHandlerbreaker.cд */
+	return (anQ4 > 0) ? (uint32_t)anQ4 : 0;
 }
 
-
-
+/*
+*********************************************************************************************************
+*	  : CountCalibAn
+*	˵: ֵͬCountCalibAnQ4
+*	    : uint8_t idx     IA_IDX/IB_IDX/IC_IDX
+*			   uint32_t rawQ4  ADCֵ(Q4)
+*	  ֵ: ֵ(A)
+*********************************************************************************************************
+*/
+float CountCalibAn(uint8_t idx, uint32_t rawQ4)
+{
+	return (float)CountCalibAnQ4(idx, rawQ4) / (1<<RMS_FRAC_BITS);
+}
 
 /*
 *********************************************************************************************************
-*	  : HAL_ADC_ConvCpltCallback
-*	˵: ADCжϻص
-*	    : 
-*	  ֵ: 
+*	  : CountMsAn
+*	˵: ADCֵֵʾ¼Ȱ
+*	    : uint8_t idx     IA_IDX/IB_IDX/IC_IDX
+*			   uint32_t msQ8   ADCֵ(Q8)
+*	  ֵ: ֵ(A)
 *********************************************************************************************************
 */
-#if 0
-void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
+float CountMsAn(uint8_t idx, uint32_t msQ8)
 {
-	osSemaphoreRelease(BinarySemAdcConvCpltHandle);
+	return CountCalibAn(idx, SqrtU32(msQ8));
 }
-#endif
 
 /*
 *********************************************************************************************************
-*	  : BreakerAdcInit
-*	˵: ADC,úϵͳֱӵ
-*	    : 
-*	  ֵ: 
+*	  : GetParaAn
+*	˵: 軻ĳ൱ǰֵ
+*	    : const breakerParaDef *para 
+*	  ֵ: ֵ(A)
 *********************************************************************************************************
 */
-void BreakerAdcInit(void)
+float GetParaAn(const breakerParaDef *para)
 {
-	/* ʼ BinarySemAdcConvCplt źṹ*/
-	osSemaphoreDef(BinarySemAdcConvCplt);
-	
-	/*  BinarySemAdcConvCpltźźΪ1 */
-	BinarySemAdcConvCpltHandle = osSemaphoreCreate(osSemaphore(BinarySemAdcConvCplt), 1);
-	
-	printf("BinarySemAdcConvCplt has created\r\n");	
+	return CountMsAn(para->idx, para->msQ8);
+}
 
-	/* ADCת:ADCת+ʱ */
-	StartAdcConvert();
-	
+/*
+*********************************************************************************************************
+*	  : GetParaAnQ4
+*	˵: 軻ĳ൱ǰֵ(Q4)ʹ
+*	    : const breakerParaDef *para 
+*	  ֵ: ֵ(AQ4)
+*********************************************************************************************************
+*/
+uint32_t GetParaAnQ4(const breakerParaDef *para)
+{
+	return CountCalibAnQ4(para->idx, SqrtU32(para->msQ8));
 }
 
 /*
 *********************************************************************************************************
-*	  : BreakerAdcProc
-*	˵: ADC,úϵͳֱӵ
-*	    : 
-*	  ֵ: 
+*	  : CountAnRawQ4
+*	˵: CountCalibAn㣺ADCֲֵһֵСanСADCֵ(Q4)
+*	    : uint8_t idx  IA_IDX/IB_IDX/IC_IDX
+*			   float an     ֵ(A)
+*			   uint32_t *rawQ4 ADCֵ(Q4)
+*	  ֵ: false-ADC
 *********************************************************************************************************
 */
-void BreakerAdcProc(void)
+static bool CountAnRawQ4(uint8_t idx, float an, uint32_t *rawQ4)
 {
+	uint32_t low = 0;
+	uint32_t high = ADC_RAW_MAX << RMS_FRAC_BITS;
+	uint32_t mid = 0;
 
-	/* ȴźͷţʱΪ2000 */
-	osSemaphoreWait(BinarySemAdcConvCpltHandle, 2000);
+	if(CountCalibAn(idx, high) < an)
+	{
+		*rawQ4 = high;
+		return false;
+	}
 
-	/* ADCݴ */
-	BreakerAdcHandler();
+	while(low < high)
+	{
+		mid = (low + high) / 2;
+		if(CountCalibAn(idx, mid) < an)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	*rawQ4 = high;
 
+	return true;
 }
 
-
-float GetIaA(void)
+/*
+*********************************************************************************************************
+*	  : CountAnRawRms
+*	˵: ɵֵУ׼ǰADCֵ
+*	    : uint8_t idx IA_IDX/IB_IDX/IC_IDX
+*			   float an    ֵ(A)
+*	  ֵ: ADCֵʱADC_RAW_MAX
+*********************************************************************************************************
+*/
+float CountAnRawRms(uint8_t idx, float an)
 {
-	return breakerParaInfo.ia.an;
+	uint32_t rawQ4 = 0;
+
+	CountAnRawQ4(idx, an, &rawQ4);
+
+	return (float)rawQ4 / (1<<RMS_FRAC_BITS);
 }
 
-float GetIbA(void)
+/*
+*********************************************************************************************************
+*	  : CountAnRawMsQ8
+*	˵: ֵΪADCֵ(Q8)ޡֵƽУ׼Q4ֵ
+*			   msQ8 >=   ֵ >= an ȼۣж迪У׼
+*	    : uint8_t idx IA_IDX/IB_IDX/IC_IDX
+*			   float an    ֵ(A)
+*	  ֵ: ֵ(Q8)ADCʱAN_RAW_MS_NONE
+*********************************************************************************************************
+*/
+uint32_t CountAnRawMsQ8(uint8_t idx, float an)
 {
-	return breakerParaInfo.ib.an;
+	uint32_t rawQ4 = 0;
+
+	if(!CountAnRawQ4(idx, an, &rawQ4))
+	{
+		return AN_RAW_MS_NONE;
+	}
+
+	/* rawQ44095*16ƽ32λ */
+	return rawQ4*rawQ4;
 }
 
-float GetIcA(void)
+/*
+*********************************************************************************************************
+*	  : AmpEstMsQ8
+*	˵: ڷֵΪmsQ8ͬھADCֵ(Q8)Ҳ
+*	    : const FFTParasDef *para 
+*	  ֵ: ֵ(Q8)
+*********************************************************************************************************
+*/
+static uint32_t AmpEstMsQ8(const FFTParasDef *para)
 {
-	return breakerParaInfo.ic.an;
-}
+	uint32_t ms = ((uint32_t)para->ampEst*para->ampEst) << AMP_EST_MS_SHIFT;
+#if !CURR_SAMPLE_DC_REMOVE
+	uint32_t dcQ4 = (uint32_t)(para->dcAn*(1<<RMS_FRAC_BITS));
 
+	/* ֱֱƽʱȡֵ */
+	ms = (ms > 0xFFFFFFFFUL - dcQ4*dcQ4) ? 0xFFFFFFFFUL : (ms + dcQ4*dcQ4);
+#endif
 
-float GetIaAver(void)
+	return ms;
+}
+
+/*
+*********************************************************************************************************
+*	  : CountAmpEst
+*	˵: ҷֵƣü1/8ڵֵAMP_EST_CONFIRM_CNTֵСֵΪ
+*			  ȷϷֵذ֡ȷϷֵֵϷԼ2.5ms(8)Чƣȫ
+*	    : const int16_t *samples ͨ֡һֵַ
+*			   uint16_t stride        ڲֵļ
+*			   int16_t dc             ֱȡһڵľֵ
+*			   uint32_t seq           ֡
+*			   AmpEstDef *est         ״̬֡ʷ
+*	  ֵ: ֵֵ(ADCֵ)
+*********************************************************************************************************
+*/
+static uint16_t CountAmpEst(const int16_t *samples, uint16_t stride, int16_t dc, uint32_t seq, AmpEstDef *est)
 {
+	int32_t x0 = 0;
+	int32_t x1 = 0;
+	int32_t prod = 0;
+	uint32_t sqr = 0;
+	uint32_t cross = 0;
+	uint32_t amp = 0;
+	uint32_t ampConfirm = 0;
+	uint32_t ampMax = 0;
+	uint16_t i = 0;
+	uint16_t j = 0;
+	bool isHistValid = (seq == est->seq + 1);
 
-    portENTER_CRITICAL();
+	for(i=0; i<ADC_SAMPLE_POINTS; i++)
+	{
+		x1 = samples[i*stride] - dc;
+		if(i >= AMP_EST_LAG)
+		{
+			x0 = samples[(i-AMP_EST_LAG)*stride] - dc;
+		}
+		else if(isHistValid)
+		{
+			x0 = est->hist[i];
+		}
+		else
+		{
+			continue;								/* ֡ȱԵǰһֵ */
+		}
+
+		/* 12λֵ|x0x1|*181 < 2^322(x0^2+x1^2)+22|x0x1| < 2^27 */
+		prod = x0*x1;
+		sqr = 2*(uint32_t)(x0*x0 + x1*x1);
+		cross = ((uint32_t)((prod < 0) ? -prod : prod) * AMP_EST_2SQRT2_Q6) >> 6;
+		if(prod < 0)
+		{
+			sqr += cross;
+		}
+		else
+		{
+			sqr = (sqr > cross) ? (sqr - cross) : 0;
+		}
+		amp = SqrtU32(sqr);
 
-	float an = breakerParaInfo.ia.anAver;
+		ampConfirm = amp;
+		for(j=0; j<AMP_EST_CONFIRM_CNT-1; j++)
+		{
+			if(est->ampPre[j] < ampConfirm)
+			{
+				ampConfirm = est->ampPre[j];
+			}
+		}
+		for(j=AMP_EST_CONFIRM_CNT-2; j>0; j--)
+		{
+			est->ampPre[j] = est->ampPre[j-1];
+		}
+		est->ampPre[0] = (uint16_t)amp;
 
-    portEXIT_CRITICAL();
+		if(ampConfirm > ampMax)
+		{
+			ampMax = ampConfirm;
+		}
+	}
 
-    return an;
+	/* 汾֡ĩβĲֵһ֡ͷ */
+	for(i=0; i<AMP_EST_LAG; i++)
+	{
+		est->hist[i] = samples[(ADC_SAMPLE_POINTS-AMP_EST_LAG+i)*stride] - dc;
+	}
+	est->seq = seq;
+
+	return (uint16_t)ampMax;
 }
 
-float GetIbAver(void)
+/*
+*********************************************************************************************************
+*	  : AdcCycleStamp
+*	˵: ϵͳSysTickǰֵõCPUʱʱ֮Ϊʱ(ڼ䱻жռõʱ)
+*			  SysTickװضжδִ(жϱλ򱻸ȼжռ)ʱδ1
+*			  PENDSTSETжϣضֵ1ģʱһģ޷ŲֵΪԼ4e9
+*	    : 
+*	  ֵ: ʱʱ
+*********************************************************************************************************
+*/
+static uint32_t AdcCycleStamp(void)
+{
+	uint32_t tick = 0;
+	uint32_t val = 0;
+	bool isPend = false;
+
+	do
+	{
+		tick = xTaskGetTickCount();
+		val = SysTick->VAL;
+		isPend = (0 != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk));
+		if(isPend)
+		{
+			val = SysTick->VAL;					/* ״ζȡװأضõһڵļֵ */
+		}
+	}while(tick != xTaskGetTickCount());
+
+	if(isPend)
+	{
+		tick++;
+	}
+
+	return tick*(SysTick->LOAD + 1) + (SysTick->LOAD - val);
+}
+
+#if ADC_PROBE_EN
+/*
+*********************************************************************************************************
+*	  : AdcProbeRecord
+*	˵: һκʱý׶εС/ֵۼӺͣۼӺͽʱͬʱ룬ֵ
+*	    : uint8_t id      ̽׶ΣAdcProbeEnum
+*			   uint32_t cycles ʱ(CPUʱ)
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void AdcProbeRecord(uint8_t id, uint32_t cycles)
+{
+	AdcProbeDef *probe = &adcProbe[id];
+
+	if((0 == probe->cnt) || (cycles < probe->minCycles))
+	{
+		probe->minCycles = cycles;
+	}
+	if(cycles > probe->maxCycles)
+	{
+		probe->maxCycles = cycles;
+	}
+	if(probe->sumCycles + cycles < probe->sumCycles)
+	{
+		probe->sumCycles >>= 1;
+		probe->cnt >>= 1;
+	}
+	probe->sumCycles += cycles;
+	probe->cnt++;
+}
+
+/*
+*********************************************************************************************************
+*	  : AdcProbeStart
+*	˵: ʱ̽㣬ڰ֡ԴӡʼʱãֻADCʹ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void AdcProbeStart(void)
+{
+	adcProbeFrameStamp = AdcCycleStamp();
+	adcProbeLapStamp = adcProbeFrameStamp;
+}
+
+/*
+*********************************************************************************************************
+*	  : AdcProbeLap
+*	˵: ʱ̽㣬¼һ̽㵽˵ĺʱΪý׶κʱĳ׶ǰʱ׶α֡
+*	    : uint8_t id ̽׶ΣAdcProbeEnum
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void AdcProbeLap(uint8_t id)
+{
+	uint32_t stamp = AdcCycleStamp();
+
+	AdcProbeRecord(id, stamp - adcProbeLapStamp);
+	adcProbeLapStamp = stamp;
+}
+
+/*
+*********************************************************************************************************
+*	  : AdcProbeTotal
+*	˵: ¼㵽˵ܺʱ
+*	    : uint8_t id ̽׶ΣAdcProbeEnum
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void AdcProbeTotal(uint8_t id)
+{
+	AdcProbeRecord(id, AdcCycleStamp() - adcProbeFrameStamp);
+}
+
+/*
+*********************************************************************************************************
+*	  : PrintAdcProbe
+*	˵: ׶κʱС//ƽֵ(CPUʱ)ͳƺڼ䱻жռõʱ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void PrintAdcProbe(void)
+{
+	static const char *const probeName[ADC_PROBE_NUM] = {"SumStat", "AmpEst", "Harm", "FreqTrack", "FftSnap", "AnCount",
+		"HarmPub", "FreqAdj", "Knob", "Quiescent", "Setting", "Warning", "Inst", "Sd", "Ld", "Frame", "Log"};
+	AdcProbeDef probe;
+	uint8_t i = 0;
+
+	printf("[Probe]:cycles @ %lu Hz\r\n", SystemCoreClock);
+	for(i=0; i<ADC_PROBE_NUM; i++)
+	{
+		portENTER_CRITICAL();
+		probe = adcProbe[i];
+		portEXIT_CRITICAL();
+		printf("  %-9s cnt %lu\tmin %lu\tmax %lu\tmean %lu\r\n", probeName[i], probe.cnt,
+			probe.minCycles, probe.maxCycles, (0 == probe.cnt) ? 0 : probe.sumCycles/probe.cnt);
+	}
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	  : HarmParasCount
+*	˵: һڵGoertzel״̬Чֵλг
+*	    : const GoertzelStateDef *state Ƶ״̬
+*			   FFTParasDef *para             
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void HarmParasCount(const GoertzelStateDef *state, FFTParasDef *para)
+{
+	int32_t re = 0;
+	int32_t im = 0;
+	uint32_t mag[HARM_BIN_NUM];
+	uint32_t angle = 0;
+	uint8_t sh = 0;
+	uint8_t i = 0;
+
+	/* X(k) = s1 - s2*e^(-jw)ֵ = 2|X(k)|/NPTȫ㣬 */
+	for(i=0; i<HARM_BIN_NUM; i++)
+	{
+		re = state[i].s1 - HARM_MUL_Q14(state[i].s2, harmCosQ14[i]);
+		im = HARM_MUL_Q14(state[i].s2, harmSinQ14[i]);
+		for(sh=0; (((re < 0) ? -re : re) | ((im < 0) ? -im : im)) >= (1 << HARM_MAG_BITS); sh++)
+		{
+			re >>= 1;
+			im >>= 1;
+		}
+		mag[i] = SqrtU32((uint32_t)(re*re + im*im)) << sh;
+		if(0 == i)
+		{
+			angle = Atan2X10Q4(im, re) + 3600*16/NPT;		/* X(k) = ye^(jw)һλ */
+		}
+	}
+
+	para->fn = (mag[0]*HARM_FN_Q4_Q9) >> 9;
+	if(para->fn < HARM_FUND_MIN_Q4)
+	{
+		para->angle = 0;
+		memset(para->harm, 0, sizeof(para->harm));
+		return;
+	}
+
+	para->angle = (uint16_t)(((angle + 8) >> 4) % 3600);	/* Ϊο */
+	for(i=0; i<FFT_HARM_NUM; i++)
+	{
+		para->harm[i] = (uint16_t)(mag[i+1]*1000/mag[0]);
+	}
+}
+
+/*
+*********************************************************************************************************
+*	  : IabcHarmCount
+*	˵: Goertzelƣǰ֡ʼڲ״̬֡ͬһڣDMAֱӼ
+*	    : const int16_t *frame ֡
+*			   uint8_t half         ֡
+*			   uint32_t seq         ֡
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void IabcHarmCount(const int16_t *frame, uint8_t half, uint32_t seq)
+{
+	static const uint8_t phaseCol[IABC_PHASE_NUM] = {ADC_FAST_COL(IA_IDX), ADC_FAST_COL(IB_IDX), ADC_FAST_COL(IC_IDX)};
+	uint32_t stamp = AdcCycleStamp();
+	uint8_t i = 0;
+	uint8_t k = 0;
+
+	if(ADC_DMA_HALF_FIRST == half)
+	{
+		memset(iabcHarmState, 0, sizeof(iabcHarmState));
+		harmSeq = seq;
+		harmIsValid = 1;
+		adcFrameStat.harmCycles = 0;
+	}
+	else if(!harmIsValid || (seq != harmSeq + 1))
+	{
+		harmIsValid = 0;				/* ǰ֡ʧ򱻸ǣڲ */
+		return;
+	}
+
+	for(i=0; i<IABC_PHASE_NUM; i++)
+	{
+		for(k=0; k<HARM_BIN_NUM; k++)
+		{
+			GoertzelQ14(&frame[phaseCol[i]], ADC_SAMPLE_POINTS, ADC_FAST_CHANLS_NUM, harmCoeffQ14[k], &iabcHarmState[i][k]);
+		}
+	}
+
+	adcFrameStat.harmCycles += AdcCycleStamp() - stamp;
+}
+
+/*
+*********************************************************************************************************
+*	  : IabcHarmPublish
+*	˵: ֡ȷδǺڵĵ״̬λгдBreakerFftͳƺʱ
+*	    : uint8_t half ֡
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void IabcHarmPublish(uint8_t half)
+{
+	uint32_t stamp = 0;
+
+	if((ADC_DMA_HALF_SECOND != half) || !harmIsValid)
+	{
+		return;
+	}
+
+	stamp = AdcCycleStamp();
+	HarmParasCount(iabcHarmState[0], &BreakerFft.ia.fftPara);
+	HarmParasCount(iabcHarmState[1], &BreakerFft.ib.fftPara);
+	HarmParasCount(iabcHarmState[2], &BreakerFft.ic.fftPara);
+	harmIsValid = 0;
+
+	adcFrameStat.harmCycles += AdcCycleStamp() - stamp;
+	if(adcFrameStat.harmCycles > adcFrameStat.harmCyclesMax)
+	{
+		adcFrameStat.harmCyclesMax = adcFrameStat.harmCycles;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	  : FreqTrackCount
+*	˵: ڰ֡ڼ(һھֵΪ㣬Բֵ1/256)ۼڹ
+*	    : const int16_t *frame ֡
+*			   uint32_t seq         ֡
+*			   int16_t dc           һڵֱ
+*			   FreqTrackDef *ft     ״̬
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void FreqTrackCount(const int16_t *frame, uint32_t seq, int16_t dc, FreqTrackDef *ft)
+{
+	static const uint8_t phaseCol[IABC_PHASE_NUM] = {ADC_FAST_COL(IA_IDX), ADC_FAST_COL(IB_IDX), ADC_FAST_COL(IC_IDX)};
+	const int16_t *samples = &frame[phaseCol[ft->phase]];
+	int32_t prev = ft->lastVal;
+	int32_t cur = 0;
+	uint32_t pos = 0;
+	uint32_t period = 0;
+	uint16_t i = 0;
+
+	if(seq != ft->seq + 1)
+	{
+		/* ֡¿ʼ */
+		ft->hasPos = 0;
+		ft->isArmed = 0;
+		prev = samples[0];
+		i = 1;
+	}
+
+	for(; i<ADC_SAMPLE_POINTS; i++)
+	{
+		cur = samples[i*ADC_FAST_CHANLS_NUM];
+		if(cur < dc - FREQ_TRACK_HYST)
+		{
+			ft->isArmed = 1;
+		}
+		else if(ft->isArmed && (prev < dc) && (cur >= dc))
+		{
+			ft->isArmed = 0;
+			pos = ((seq*ADC_SAMPLE_POINTS + i - 1) << 8) + (uint32_t)(((dc - prev) << 8) / (cur - prev));
+			if(ft->hasPos)
+			{
+				period = pos - ft->lastPos;
+				/* ӦڵǰNPT㸽Ϊţۼ */
+				if((period >= (NPT*3/4 << 8)) && (period <= (NPT*3/2 << 8)))
+				{
+					ft->periodSum += period;
+					ft->periodCnt++;
+				}
+				else
+				{
+					ft->periodSum = 0;
+					ft->periodCnt = 0;
+				}
+			}
+			ft->lastPos = pos;
+			ft->hasPos = 1;
+		}
+		prev = cur;
+	}
+
+	ft->lastVal = (int16_t)prev;
+	ft->seq = seq;
+}
+
+/*
+*********************************************************************************************************
+*	  : FreqTrackAdjust
+*	˵: ۼƹFREQ_TRACK_AVG_CNTںƽڵTIM1ֵ² = ԭ*ƽڵ/NPT
+*			  Сʱѡһ࣬Сʱֵǰ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void FreqTrackAdjust(void)
+{
+	const FFTParasDef *para[IABC_PHASE_NUM] = {&BreakerFft.ia.fftPara, &BreakerFft.ib.fftPara, &BreakerFft.ic.fftPara};
+	uint32_t timPeriod = 0;
+	uint32_t newPeriod = 0;
+	uint8_t i = 0;
+
+	if(para[freqTrack.phase]->acAn < FREQ_TRACK_AC_MIN)
+	{
+		for(i=0; i<IABC_PHASE_NUM; i++)
+		{
+			if(para[i]->acAn > para[freqTrack.phase]->acAn)
+			{
+				freqTrack.phase = i;
+			}
+		}
+		freqTrack.hasPos = 0;
+		freqTrack.periodSum = 0;
+		freqTrack.periodCnt = 0;
+		return;
+	}
+
+	if(freqTrack.periodCnt < FREQ_TRACK_AVG_CNT)
+	{
+		return;
+	}
+
+	/* (ֵ+1)Լ16700ƽ(Q8)96*256˻32λ */
+	timPeriod = GetAdcTrigTimPeriod();
+	newPeriod = ((timPeriod + 1)*(freqTrack.periodSum/freqTrack.periodCnt) + (NPT << 7)) / (NPT << 8) - 1;
+	if(newPeriod < FREQ_TRACK_PERIOD_MIN)
+	{
+		newPeriod = FREQ_TRACK_PERIOD_MIN;
+	}
+	else if(newPeriod > FREQ_TRACK_PERIOD_MAX)
+	{
+		newPeriod = FREQ_TRACK_PERIOD_MAX;
+	}
+
+	if(newPeriod != timPeriod)
+	{
+		SetAdcTrigTimPeriod(newPeriod);
+		phaseFreq = (uint16_t)((ADC_TRIG_TIM_CLK/NPT + (newPeriod + 1)/2) / (newPeriod + 1));	/* NPTӦƵʣ뵽1Hz */
+		freqTrack.hasPos = 0;				/* Խļֲʻϣ */
+	}
+	freqTrack.periodSum = 0;
+	freqTrack.periodCnt = 0;
+}
+
+/*
+*********************************************************************************************************
+*	  : FftSnapCopy
+*	˵: FFTʱǰ֡ջDMA֡ȡڼ
+*	    : const int16_t *frame ֡
+*			   uint8_t half         ֡
+*			   uint32_t seq         ֡
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void FftSnapCopy(const int16_t *frame, uint8_t half, uint32_t seq)
+{
+	static const uint8_t phaseCol[IABC_PHASE_NUM] = {ADC_FAST_COL(IA_IDX), ADC_FAST_COL(IB_IDX), ADC_FAST_COL(IC_IDX)};
+	const int16_t *samples = &frame[phaseCol[fftSnap.phase]];
+	int16_t *dst = NULL;
+	uint16_t i = 0;
+
+	fftSnap.stateNext = fftSnap.state;
+	if((FFT_SNAP_REQ == fftSnap.state) && (ADC_DMA_HALF_FIRST == half))
+	{
+		dst = &fftSnap.buf[0];
+		fftSnap.seq = seq;
+		fftSnap.stateNext = FFT_SNAP_FILL;
+	}
+	else if(FFT_SNAP_FILL == fftSnap.state)
+	{
+		if((ADC_DMA_HALF_SECOND == half) && (seq == fftSnap.seq + 1))
+		{
+			dst = &fftSnap.buf[2*ADC_SAMPLE_POINTS];
+			fftSnap.stateNext = FFT_SNAP_READY;
+		}
+		else
+		{
+			fftSnap.stateNext = FFT_SNAP_REQ;		/* ֡ȴһǰ֡¿ */
+		}
+	}
+
+	if(NULL == dst)
+	{
+		return;
+	}
+	for(i=0; i<ADC_SAMPLE_POINTS; i++)
+	{
+		dst[2*i] = (int16_t)(samples[i*ADC_FAST_CHANLS_NUM] << FFT_SNAP_IN_SHIFT);
+		dst[2*i+1] = 0;
+	}
+}
+
+/*
+*********************************************************************************************************
+*	  : FftSnapCommit
+*	˵: ֡δʱ״̬Чʱµȴǰ֡
+*	    : uint8_t isOverrun ð֡ȡڼǷDMA
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void FftSnapCommit(uint8_t isOverrun)
+{
+	if((FFT_SNAP_REQ != fftSnap.state) && (FFT_SNAP_FILL != fftSnap.state))
+	{
+		return;
+	}
+	fftSnap.state = isOverrun ? FFT_SNAP_REQ : fftSnap.stateNext;
+}
+
+/*
+*********************************************************************************************************
+*	  : BreakerFftProc
+*	˵: ̨FFTվ64㶨FFT1~15гЧֵTHDдBreakerFftȻһա
+*			  ڵȼУʱɱADCռӰ챣·
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void BreakerFftProc(void)
+{
+	FFTParasDef *para[IABC_PHASE_NUM] = {&BreakerFft.ia.fftPara, &BreakerFft.ib.fftPara, &BreakerFft.ic.fftPara};
+	uint16_t spec[FFT_SPEC_NUM];
+	float re = 0;
+	float im = 0;
+	float mag = 0;
+	float mag1 = 0;
+	float harmSqrSum = 0;
+	uint16_t thd = 0;
+	uint8_t k = 0;
+
+	if(FFT_SNAP_IDLE == fftSnap.state)
+	{
+		fftSnap.state = FFT_SNAP_REQ;
+		return;
+	}
+	if(FFT_SNAP_READY != fftSnap.state)
+	{
+		return;
+	}
+
+	FftR4Q15(fftSnap.buf, NPT);
+
+	/* ΪX(k)*8/NPTʵźkгЧֵ = 2*|X(k)|*2/NPT = ||*22/8ֵQ4||*22 */
+	for(k=1; k<=FFT_SPEC_NUM; k++)
+	{
+		re = fftSnap.buf[2*k];
+		im = fftSnap.buf[2*k+1];
+		mag = sqrtf(re*re + im*im);
+		spec[k-1] = (uint16_t)(mag*2.8284271f);
+		if(1 == k)
+		{
+			mag1 = mag;
+		}
+		else
+		{
+			harmSqrSum += mag*mag;
+		}
+	}
+	if(spec[0] >= HARM_FUND_MIN_Q4)
+	{
+		thd = (uint16_t)(sqrtf(harmSqrSum)*1000/mag1);
+	}
+
+	portENTER_CRITICAL();
+	memcpy(para[fftSnap.phase]->spec, spec, sizeof(spec));
+	para[fftSnap.phase]->thd = thd;
+	portEXIT_CRITICAL();
+
+	/* һ࣬ADC */
+	fftSnap.phase = (fftSnap.phase + 1) % IABC_PHASE_NUM;
+	fftSnap.state = FFT_SNAP_REQ;
+}
+
+static void IabcAnCount(uint8_t half, bool isGap, const SumStatDef *fresh)
+{
+	/* AࣺAADCͨɼֱֵֵ BreakerFft.ia.fftPara */
+	CountFFTParasSliding(&fresh[0], iabcHalfStat[0], half, isGap, &BreakerFft.ia.fftPara);
+	/* ֵۼӼ */
+	BreakerFft.ia.anSum += FFT_CALIB_AN(BreakerFft.ia.fftPara);
+	/* жֱʹADCֵֵʾ¼ʱGetParaAn軻 */
+	breakerParaInfo.ia.msQ8 = BreakerFft.ia.fftPara.msQ8;
+	breakerParaInfo.ia.msSum += breakerParaInfo.ia.msQ8;
+	/* ڷֵľֵ·˲ʱж */
+	breakerParaInfo.ia.msFastQ8 = AmpEstMsQ8(&BreakerFft.ia.fftPara);
+	
+	/* IbL */
+	CountFFTParasSliding(&fresh[1], iabcHalfStat[1], half, isGap, &BreakerFft.ib.fftPara);
+	BreakerFft.ib.anSum += FFT_CALIB_AN(BreakerFft.ib.fftPara);
+	breakerParaInfo.ib.msQ8 = BreakerFft.ib.fftPara.msQ8;
+	breakerParaInfo.ib.msSum += breakerParaInfo.ib.msQ8;
+	breakerParaInfo.ib.msFastQ8 = AmpEstMsQ8(&BreakerFft.ib.fftPara);
+
+	/* IcL */
+	CountFFTParasSliding(&fresh[2], iabcHalfStat[2], half, isGap, &BreakerFft.ic.fftPara);
+	BreakerFft.ic.anSum += FFT_CALIB_AN(BreakerFft.ic.fftPara);
+	breakerParaInfo.ic.msQ8 = BreakerFft.ic.fftPara.msQ8;
+	breakerParaInfo.ic.msSum += breakerParaInfo.ic.msQ8;
+	breakerParaInfo.ic.msFastQ8 = AmpEstMsQ8(&BreakerFft.ic.fftPara);
+}
+
+
+static void AnAverCount( void )
+{
+	/* periodIdx */
+	breakerParaInfo.periodIdx++;
+	
+	if(breakerParaInfo.periodIdx>=AN_AVER_COUNT) //PHASE_FREQ
+	{
+	    portENTER_CRITICAL();
+		/* ԭʼֵƽֵ㣿 */
+		BreakerFft.ia.anAver = BreakerFft.ia.anSum/AN_AVER_COUNT;
+		BreakerFft.ib.anAver = BreakerFft.ib.anSum/AN_AVER_COUNT;
+		BreakerFft.ic.anAver = BreakerFft.ic.anSum/AN_AVER_COUNT;
+		/* ֵƽֵڶȡʱ */
+		breakerParaInfo.ia.msAver = (uint32_t)(breakerParaInfo.ia.msSum/AN_AVER_COUNT);
+		breakerParaInfo.ib.msAver = (uint32_t)(breakerParaInfo.ib.msSum/AN_AVER_COUNT);
+		breakerParaInfo.ic.msAver = (uint32_t)(breakerParaInfo.ic.msSum/AN_AVER_COUNT);
+        portEXIT_CRITICAL();
+		/* ȫ㣬ȴһμ */
+		BreakerFft.ia.anSum = 0;
+		BreakerFft.ib.anSum = 0;
+		BreakerFft.ic.anSum = 0;
+
+		breakerParaInfo.ia.msSum = 0;
+		breakerParaInfo.ib.msSum = 0;
+		breakerParaInfo.ic.msSum = 0;
+		
+		breakerParaInfo.periodIdx = 0;
+	}
+}
+
+static void BreakerAdcHandler(void)
+{
+	const int16_t *frame = NULL;						/* ֡У[][ͨ] */
+	SumStatDef iabcStat[IABC_PHASE_NUM];				/* ð֡ͳֵ */
+	AmpEstDef ampEst[IABC_PHASE_NUM];					/* ״̬֡δǲд */
+	FreqTrackDef freqTrackNew;							/* Ƶʸ״̬֡δǲд */
+	const FFTParasDef *trackPara = NULL;
+	uint16_t ampVal[IABC_PHASE_NUM];					/* ð֡ڷֵ */
+	uint8_t half = 0;
+	uint32_t seq = 0;
+	uint32_t frames = 0;								/* һͱжϵİ֡֡򸲸Ƕʱ1 */
+	uint8_t isOverrun = 0;
+				
+	
+	/* ȡһȶİ֡DMAʱдһ֡ΪȡУDMAڶȡǰתظð֡жøǱ־ */
+	portENTER_CRITICAL();
+	half = adcDmaHalfIdx;
+	seq = adcDmaHalf[half].seq;
+	adcFrameUs = adcDmaHalf[half].usStamp;
+	adcDmaHalf[half].isBusy = 1;
+	adcDmaHalf[half].isOverrun = 0;
+	portEXIT_CRITICAL();
+
+	if(seq == adcFrameStat.procSeq)
+	{
+		/* ð֡Ѵ(źȴʱ) */
+		portENTER_CRITICAL();
+		adcDmaHalf[half].isBusy = 0;
+		portEXIT_CRITICAL();
+		return;
+	}
+	adcFrameStat.dropCnt += seq - adcFrameStat.procSeq - 1;
+	adcFrameStat.procSeq = seq;
+	ADC_PROBE_START();
+
+	/* ֱDMAϰͨð֡תÿ */
+	frame = (const int16_t *)&adcVals[half*ADC_SAMPLE_POINTS][0];
+	CountSumStat(&frame[ADC_FAST_COL(IA_IDX)], ADC_SAMPLE_POINTS, ADC_FAST_CHANLS_NUM, &iabcStat[0]);
+	CountSumStat(&frame[ADC_FAST_COL(IB_IDX)], ADC_SAMPLE_POINTS, ADC_FAST_CHANLS_NUM, &iabcStat[1]);
+	CountSumStat(&frame[ADC_FAST_COL(IC_IDX)], ADC_SAMPLE_POINTS, ADC_FAST_CHANLS_NUM, &iabcStat[2]);
+	ADC_PROBE_LAP(ADC_PROBE_SUM_STAT);
+
+	/* ڷֵƣֱȡһڵľֵ */
+	memcpy(ampEst, iabcAmpEst, sizeof(ampEst));
+	ampVal[0] = CountAmpEst(&frame[ADC_FAST_COL(IA_IDX)], ADC_FAST_CHANLS_NUM, (int16_t)BreakerFft.ia.fftPara.dcAn, seq, &ampEst[0]);
+	ampVal[1] = CountAmpEst(&frame[ADC_FAST_COL(IB_IDX)], ADC_FAST_CHANLS_NUM, (int16_t)BreakerFft.ib.fftPara.dcAn, seq, &ampEst[1]);
+	ampVal[2] = CountAmpEst(&frame[ADC_FAST_COL(IC_IDX)], ADC_FAST_CHANLS_NUM, (int16_t)BreakerFft.ic.fftPara.dcAn, seq, &ampEst[2]);
+	ADC_PROBE_LAP(ADC_PROBE_AMP_EST);
+
+	/* гGoertzel */
+	IabcHarmCount(frame, half, seq);
+	ADC_PROBE_LAP(ADC_PROBE_HARM);
+
+	/*  */
+	freqTrackNew = freqTrack;
+	trackPara = (0 == freqTrack.phase) ? &BreakerFft.ia.fftPara : ((1 == freqTrack.phase) ? &BreakerFft.ib.fftPara : &BreakerFft.ic.fftPara);
+	FreqTrackCount(frame, seq, (int16_t)trackPara->dcAn, &freqTrackNew);
+	ADC_PROBE_LAP(ADC_PROBE_FREQ_TRACK);
+
+	/* ̨FFTڿ */
+	FftSnapCopy(frame, half, seq);
+
+	portENTER_CRITICAL();
+	adcDmaHalf[half].isBusy = 0;
+	isOverrun = adcDmaHalf[half].isOverrun;
+	portEXIT_CRITICAL();
+
+	FftSnapCommit(isOverrun);
+	ADC_PROBE_LAP(ADC_PROBE_FFT_SNAP);
+
+	/* ȡڼѱǣð֡ȴһȶ֡ */
+	if(isOverrun)
+	{
+		adcFrameStat.overrunCnt++;
+		harmIsValid = 0;
+		#if BREAKER_ADC_LOG
+		log_t("adc frame %lu overrun\r\n", seq);
+		#endif
+		return;
+	}
+
+	memcpy(iabcAmpEst, ampEst, sizeof(iabcAmpEst));
+	freqTrack = freqTrackNew;
+	BreakerFft.ia.fftPara.ampEst = ampVal[0];
+	BreakerFft.ib.fftPara.ampEst = ampVal[1];
+	BreakerFft.ic.fftPara.ampEst = ampVal[2];
+
+	frames = seq - adcEvalSeq;
+	if(frames > ADC_FRAME_CATCHUP_MAX)
+	{
+		frames = ADC_FRAME_CATCHUP_MAX;
+	}
+	adcEvalSeq = seq;
+	IabcAnCount(half, (frames != 1), iabcStat);
+	ADC_PROBE_LAP(ADC_PROBE_AN_COUNT);
+	IabcHarmPublish(half);
+	ADC_PROBE_LAP(ADC_PROBE_HARM_PUB);
+	FreqTrackAdjust();
+	AnAverCount();
+	ADC_PROBE_LAP(ADC_PROBE_FREQ_ADJUST);
+		
+	/* λλ룬ֻDMAжеĵɨֵʱ */
+	if(adcSlowSeq != buttonDecode.slowSeq)
+	{
+		ButtonDecode();
+		ADC_PROBE_LAP(ADC_PROBE_KNOB);
+	}
+
+	/* BreakerHandlerbreaker.cдαÿ֡һμȱʧİ֡Աֵ֡㣬⶯ʱ䱻 */
+	adcFrameStat.catchUpCnt += frames - 1;
+	for(; frames>0; frames--)
+	{
+		BreakerHandler(&breakerParaInfo);
+	}
+	ADC_PROBE_TOTAL(ADC_PROBE_FRAME);
+}
+
+
+
+
+/*
+*********************************************************************************************************
+*	  : AdcWaitFlag
+*	˵: ʱѯȴADC־λΪָ״̬
+*	    : uint32_t flag       ADC־λ
+*			   bit_status_t state ȴ״̬
+*	  ֵ: true-ѵָ״̬false-ȴʱ
+*********************************************************************************************************
+*/
+static bool AdcWaitFlag(uint32_t flag, bit_status_t state)
+{
+	uint16_t cnt = 0;
+
+	while(adc_flag_status_get(ADC1, flag) != state)
+	{
+		if(++cnt >= ADC_SLOW_SCAN_TIMEOUT)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+*********************************************************************************************************
+*	  : AdcSlowChanlsScan
+*	˵: ɨλԴͨͣʱDMAһ0~6ͨɨ貢ѯȡ
+*			  ȻָͨĶʱDMAжеã7ͨתԼ20usԶСڲ
+*			  ADCδֹͣʱüĴдɨ貢ͨʽдĿŹþֲ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void AdcSlowChanlsScan(void)
+{
+	uint32_t cfg = 0;
+	uint8_t channel = 0;
+
+	/* ֹͣʱתرDMA󣬱ͨд */
+	adc_conversion_stop(ADC1);
+	if(!AdcWaitFlag(ADC_FLAG_ADSTOP, RESET))
+	{
+		adcSlowScanFailCnt++;
+		adc_conversion_start(ADC1);
+		return;
+	}
+	adc_dma_enable_ctrl(ADC1, DISABLE);
+
+	/* ģ⿴ŹֵֻADCֹͣʱд */
+	cfg = ADC1->CFG;
+	if(adcAwdCfgPending)
+	{
+		adcAwdCfgPending = 0;
+		adc_watchdog_thresholds_set(ADC1, adcAwdHigh, 0);
+		if(adcAwdIsEnable)
+		{
+			cfg |= ADC_CFG_WDGEN;
+		}
+		else
+		{
+			cfg &= ~ADC_CFG_WDGEN;
+		}
+	}
+
+	/* лΪѡеͨɨڼرտŹ */
+	ADC1->CFG = cfg & ~(ADC_CFG_TRGMODE | ADC_CFG_WDGEN);
+	ADC1->CHANSEL = ADC_SLOW_CHANLS;
+	adc_conversion_start(ADC1);
+
+	for(channel = 0; channel < ADC_SLOW_CHANLS_NUM; channel++)
+	{
+		if(!AdcWaitFlag(ADC_FLAG_EOCH, SET))
+		{
+			break;
+		}
+		adcSlowVals[channel] = adc_conversion_value_get(ADC1);		/* ȡͬʱEOCH */
+	}
+	if(ADC_SLOW_CHANLS_NUM == channel)
+	{
+		adcSlowSeq++;
+	}
+
+	/* ָͨTIM1ʱѴڵͨãֹͣʱҲֻܼдָ */
+	adc_conversion_stop(ADC1);
+	if(!AdcWaitFlag(ADC_FLAG_ADSTOP, RESET))
+	{
+		adcSlowScanFailCnt++;
+	}
+	ADC1->CHANSEL = ADC_FAST_CHANLS;
+	ADC1->CFG = cfg;
+	adc_dma_enable_ctrl(ADC1, ENABLE);
+	adc_conversion_start(ADC1);
+}
+
+/*
+*********************************************************************************************************
+*	  : AdcDmaXferCpltCallback
+*	˵: ADC DMA봫/ɻصDMA1ͨ1же
+*	    : uint8_t half ȶɶİ֡ADC_DMA_HALF_FIRST  ADC_DMA_HALF_SECOND
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void AdcDmaXferCpltCallback(uint8_t half)
+{
+	static uint8_t slowScanDiv = 0;
+	uint32_t usStamp = GetUsStamp();					/* ڵɨȡʱð֡һʱ */
+
+	/* һڵĵսһTIM1Լһڴ˲ͨɨ */
+	if(ADC_DMA_HALF_SECOND == half)
+	{
+		if(++slowScanDiv >= ADC_SLOW_SCAN_DIV)
+		{
+			slowScanDiv = 0;
+			AdcSlowChanlsScan();
+		}
+	}
+
+	/* DMAʼдһ֡ڶȡð֡øǱ־ */
+	if(adcDmaHalf[half^1].isBusy)
+	{
+		adcDmaHalf[half^1].isOverrun = 1;
+	}
+
+	adcDmaHalf[half].seq = ++adcDmaFrameSeq;
+	adcDmaHalf[half].usStamp = usStamp;
+	adcDmaHalfIdx = half;
+	osSemaphoreRelease(BinarySemAdcConvCpltHandle);
+}
+
+/*
+*********************************************************************************************************
+*	  : AdcWatchdogConfig
+*	˵: ģ⿴Źѿ۵ʹֵܼһεɨADCֹͣʱдĴ(100ms)
+*	    : bool isEnable  Ƿʹ
+*			   uint16_t high  ֵADCԭʼֵ
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void AdcWatchdogConfig(bool isEnable, uint16_t high)
+{
+	if((isEnable == adcAwdIsEnable) && (high == adcAwdHigh))
+	{
+		return;
+	}
+
+	portENTER_CRITICAL();
+	adcAwdIsEnable = isEnable;
+	adcAwdHigh = high;
+	adcAwdCfgPending = 1;
+	portEXIT_CRITICAL();
+}
+
+/*
+*********************************************************************************************************
+*	  : AdcWatchdogIrqHandler
+*	˵: ģ⿴Źжϴһ֡ʱADC_AWD_CONFIRM_CNTͬԽ޼ֱѿۣ
+*			  ADCź㡣ADC1же
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void AdcWatchdogIrqHandler(void)
+{
+	uint32_t row = 0;
+
+	adc_intetrrupt_flag_clear(ADC1, ADC_INTR_WDEVT);
+
+	/* DMAʣഫõǰľţͬһɨжԽֻһ */
+	row = (NPT*ADC_FAST_CHANLS_NUM - dma_data_counter_get(DMA1_CHANNEL1)) / ADC_FAST_CHANLS_NUM;
+	row = adcDmaFrameSeq*ADC_SAMPLE_POINTS + (row % ADC_SAMPLE_POINTS);
+
+	if((0 == adcAwdCnt) || (row - adcAwdFirstRow >= ADC_SAMPLE_POINTS))
+	{
+		adcAwdCnt = 1;
+		adcAwdFirstRow = row;
+		adcAwdLastRow = row;
+	}
+	else if(row != adcAwdLastRow)
+	{
+		adcAwdCnt++;
+		adcAwdLastRow = row;
+	}
+
+	if(adcAwdCnt >= ADC_AWD_CONFIRM_CNT)
+	{
+		TkOn();
+		adcAwdTripped = 1;
+		adcAwdCnt = 0;
+		adc_interrupt_config(ADC1, ADC_INTR_WDEVT, DISABLE);	/* ѿۺжϣɱɺ´ */
+	}
+}
+
+bool IsAdcWatchdogTripped(void)
+{
+	return (adcAwdTripped != 0);
+}
+
+void ClrAdcWatchdogTripped(void)
+{
+	portENTER_CRITICAL();
+	adcAwdTripped = 0;
+	adcAwdCnt = 0;
+	adc_intetrrupt_flag_clear(ADC1, ADC_INTR_WDEVT);
+	adc_interrupt_config(ADC1, ADC_INTR_WDEVT, ENABLE);
+	portEXIT_CRITICAL();
+}
+
+/*
+*********************************************************************************************************
+*	  : GetAdcFrameStat
+*	˵: ȡADC DMA֡ż֡ͳ
+*	    : AdcFrameStatDef *stat ͳƽ
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void GetAdcFrameStat(AdcFrameStatDef *stat)
+{
+	portENTER_CRITICAL();
+	*stat = adcFrameStat;
+	stat->frameSeq = adcDmaFrameSeq;
+	stat->slowScanFailCnt = adcSlowScanFailCnt;
+	portEXIT_CRITICAL();
+}
+
+/*
+*********************************************************************************************************
+*	  : GetAdcFrameUs
+*	˵: ȡڴİ֡ʱ̣ݴ˼¼жڵĲ֡
+*	    : 
+*	  ֵ: ʱ(us)GetUsStamp
+*********************************************************************************************************
+*/
+uint32_t GetAdcFrameUs(void)
+{
+	return adcFrameUs;
+}
+
+/*
+*********************************************************************************************************
+*	  : GetPhaseFreq
+*	˵: ٵĵƵʣFreqTrackAdjustTIM1ֵphaseFreq뵽1Hz
+*	    : 
+*	  ֵ: Ƶ(Hz)
+*********************************************************************************************************
+*/
+uint16_t GetPhaseFreq(void)
+{
+	return phaseFreq;
+}
+
+/*
+*********************************************************************************************************
+*	  : GetPhaseFreqX100
+*	˵: ٵĵƵʣλ0.01Hz
+*	    : 
+*	  ֵ: Ƶ(0.01Hz)
+*********************************************************************************************************
+*/
+uint16_t GetPhaseFreqX100(void)
+{
+	return (uint16_t)((ADC_TRIG_TIM_CLK/NPT)*100 / (GetAdcTrigTimPeriod() + 1));
+}
+
+/*
+*********************************************************************************************************
+*	  : HAL_ADC_ConvCpltCallback
+*	˵: ADCжϻص
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+#if 0
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
+{
+	osSemaphoreRelease(BinarySemAdcConvCpltHandle);
+}
+#endif
+
+/*
+*********************************************************************************************************
+*	  : BreakerAdcInit
+*	˵: ADC,úϵͳֱӵ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void BreakerAdcInit(void)
+{
+	/* ʼ BinarySemAdcConvCplt źṹ*/
+	osSemaphoreDef(BinarySemAdcConvCplt);
+	
+	/*  BinarySemAdcConvCpltźźΪ1 */
+	BinarySemAdcConvCpltHandle = osSemaphoreCreate(osSemaphore(BinarySemAdcConvCplt), 1);
+	
+	printf("BinarySemAdcConvCplt has created\r\n");	
+
+	/* У׼ϵcalibMeterEx㣬MemMgrInitBSPʼ */
+	CalibLutInit();
+	breakerParaInfo.ia.idx = IA_IDX;
+	breakerParaInfo.ib.idx = IB_IDX;
+	breakerParaInfo.ic.idx = IC_IDX;
+
+	/* ADCת:ADCת+ʱ */
+	StartAdcConvert();
+	
+}
+
+/*
+*********************************************************************************************************
+*	  : BreakerAdcProc
+*	˵: ADC,úϵͳֱӵ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void BreakerAdcProc(void)
+{
+
+	/* ȴźͷţʱΪ2000 */
+	osSemaphoreWait(BinarySemAdcConvCpltHandle, 2000);
+
+	/* ADCݴ */
+	BreakerAdcHandler();
+
+}
+
+
+float GetIaA(void)
+{
+	return GetParaAn(&breakerParaInfo.ia);
+}
+
+float GetIbA(void)
+{
+	return GetParaAn(&breakerParaInfo.ib);
+}
+
+float GetIcA(void)
+{
+	return GetParaAn(&breakerParaInfo.ic);
+}
+
+
+float GetIaAver(void)
+{
+
+    portENTER_CRITICAL();
+
+	uint32_t ms = breakerParaInfo.ia.msAver;
+
+    portEXIT_CRITICAL();
+
+    return CountMsAn(IA_IDX, ms);
+}
+
+float GetIbAver(void)
 {
 	
     portENTER_CRITICAL();
 	
-	float an = breakerParaInfo.ib.anAver;
+	uint32_t ms = breakerParaInfo.ib.msAver;
 	
     portEXIT_CRITICAL();
 	
-    return an;
+    return CountMsAn(IB_IDX, ms);
 }
 
 float GetIcAver(void)
@@ -584,11 +2034,11 @@ float GetIcAver(void)
 	
     portENTER_CRITICAL();
 	
-	float an = breakerParaInfo.ic.anAver;
+	uint32_t ms = breakerParaInfo.ic.msAver;
    
 	portEXIT_CRITICAL();
 	
-    return an;
+    return CountMsAn(IC_IDX, ms);
 }
 
 float GetAnRawIaAver(void)
@@ -638,29 +2088,18 @@ float GetAnRawIcAver(void)
 void AdcPrint(void)
 {
 	#if 1
-	uint8_t points = 0;
-	uint8_t channel = 0;
-	
 	while(1)
 	{
 		delay(1000);
 		if(ADC_DMA_TRANSFER == SET)
 		{
-			for(channel=0; channel<ADC_CHANLS_NUM; channel++)
-			{
-				for(points=0; points<ADC_SAMPLE_POINTS; points++)
-				{
-					adcValsFftIn[channel][points] = adcVals[points][channel];
-				}				
-			}		
-			
 			/* 洢λADCֵ */
-			ButtonAdcValue0 = adcValsFftIn[0][7];
-			ButtonAdcValue1 = adcValsFftIn[1][7];
-			ButtonAdcValue2 = adcValsFftIn[2][7];
-			ButtonAdcValue3 = adcValsFftIn[3][7];
-			ButtonAdcValue4 = adcValsFftIn[4][7];
-			ButtonAdcValue5 = adcValsFftIn[5][7];		
+			ButtonAdcValue0 = adcSlowVals[BUTTON_0_IDX];
+			ButtonAdcValue1 = adcSlowVals[BUTTON_1_IDX];
+			ButtonAdcValue2 = adcSlowVals[BUTTON_2_IDX];
+			ButtonAdcValue3 = adcSlowVals[BUTTON_3_IDX];
+			ButtonAdcValue4 = adcSlowVals[BUTTON_4_IDX];
+			ButtonAdcValue5 = adcSlowVals[BUTTON_5_IDX];		
 			/* λֵλֵ */
 			S1_VAL = ButtonGearConvert(ButtonAdcValue0);
 			S2_VAL = ButtonGearConvert(ButtonAdcValue1);
@@ -724,9 +2163,9 @@ void AdcPrint(void)
 /*
 *********************************************************************************************************
 *	  : ButtonGearConvert
-*	˵: λADCֵתΪǰĵλֵ
-*	    : 
-*	  ֵ: 
+*	˵: λADCֵתΪǰĵλֵȿ㲻𵵱Ƚ
+*	    : uint32_t Value λADCֵ
+*	  ֵ: λֵ0~90ΪOFF
 *********************************************************************************************************
 */
 	/* ADCΪ12λλתλֵΪ4096(3.3V)
@@ -746,49 +2185,107 @@ void AdcPrint(void)
 	*/
 uint8_t ButtonGearConvert(uint32_t Value)
 {
-	uint32_t ButtonAdcValue = Value;
-	uint8_t  S_VAL = 0;
-	if((ButtonAdcValue >= 0) && (ButtonAdcValue <=100))
+	uint32_t pos = 0;
+
+	if(Value > ADC_RAW_MAX)
 	{
-		S_VAL = 0;									/* OFF */
+		Value = ADC_RAW_MAX;
 	}
-	else if((ButtonAdcValue >= 101) && (ButtonAdcValue <= 590))
+	/* ȿ1ƽƵһΪλOFF0~100ƽƺһ0 */
+	pos = Value + BUTTON_GEAR_STEP - (BUTTON_GEAR_OFF_MAX+1);
+	return (uint8_t)((pos*BUTTON_GEAR_STEP_RECIP) >> BUTTON_GEAR_RECIP_SHIFT);
+}
+
+/*
+*********************************************************************************************************
+*	  : ButtonDecode
+*	˵: λλ룬ÿεɨãλBUTTON_AVER_NUMɨֵƽ㵵λƽֵδԽ
+*			  ǰλ߽BUTTON_HYSTʱֵǰλµλBUTTON_SETTLE_SCANSɨ費ȷϣ
+*			  ȷϺS1_VAL~S6_VAL仯1ݴװֵϵ״ɨֱȷ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void ButtonDecode(void)
+{
+	uint8_t *const gearVal[BUTTON_NUM] = {&S1_VAL, &S2_VAL, &S3_VAL, &S4_VAL, &S5_VAL, &S6_VAL};
+	uint32_t *const averVal[BUTTON_NUM] = {&ButtonAdcValue0, &ButtonAdcValue1, &ButtonAdcValue2,
+											&ButtonAdcValue3, &ButtonAdcValue4, &ButtonAdcValue5};
+	const uint8_t idx = buttonDecode.histIdx;
+	bool isChg = false;
+	uint32_t aver = 0;
+	uint16_t raw = 0;
+	uint8_t gear = 0;
+	uint8_t i = 0;
+	uint8_t j = 0;
+
+	buttonDecode.slowSeq = adcSlowSeq;
+	buttonDecode.histIdx = (idx + 1) & (BUTTON_AVER_NUM - 1);
+	for(i = 0; i < BUTTON_NUM; i++)
 	{
-		S_VAL = 1;									/* 1 */
+		raw = adcSlowVals[BUTTON_0_IDX+i];
+		if(0 == buttonDecode.chgSeq)
+		{
+			/* ״ɨƽ */
+			for(j = 0; j < BUTTON_AVER_NUM; j++)
+			{
+				buttonDecode.hist[i][j] = raw;
+			}
+			buttonDecode.averSum[i] = raw << BUTTON_AVER_SHIFT;
+		}
+		else
+		{
+			buttonDecode.averSum[i] += raw - buttonDecode.hist[i][idx];
+			buttonDecode.hist[i][idx] = raw;
+		}
+		aver = buttonDecode.averSum[i] >> BUTTON_AVER_SHIFT;
+		*averVal[i] = aver;
+
+		/* ƽֵƫƻزԿڵǰλл */
+		gear = buttonDecode.gear[i];
+		if((0 == buttonDecode.chgSeq)
+			|| (gear < ButtonGearConvert((aver > BUTTON_HYST) ? (aver - BUTTON_HYST) : 0))
+			|| (gear > ButtonGearConvert(aver + BUTTON_HYST)))
+		{
+			gear = ButtonGearConvert(aver);
+		}
+
+		if(gear != buttonDecode.pending[i])
+		{
+			buttonDecode.pending[i] = gear;
+			buttonDecode.settleCnt[i] = 0;
+		}
+		if((0 != buttonDecode.chgSeq)
+			&& ((gear == buttonDecode.gear[i]) || (++buttonDecode.settleCnt[i] < BUTTON_SETTLE_SCANS)))
+		{
+			continue;
+		}
+		buttonDecode.gear[i] = gear;
+		*gearVal[i] = gear;
+		isChg = true;
 	}
-	else if((ButtonAdcValue >= 591) && (ButtonAdcValue <= 1080))
-	{
-		S_VAL = 2;									/* 2 */
-	}	
-	else if((ButtonAdcValue >= 1081) && (ButtonAdcValue <= 1570))
-	{
-		S_VAL = 3;									/* 3 */
-	}		
-	else if((ButtonAdcValue >= 1571) && (ButtonAdcValue <= 2060))
+
+	if(isChg)
 	{
-		S_VAL = 4;									/* 4 */
+		if(0 == ++buttonDecode.chgSeq)
+		{
+			buttonDecode.chgSeq = 1;
+		}
 	}
-	else if((ButtonAdcValue >= 2061) && (ButtonAdcValue <= 2550))
-	{
-		S_VAL = 5;									/* 5 */
-	}	
-	else if((ButtonAdcValue >= 2551) && (ButtonAdcValue <= 3040))
-	{
-		S_VAL = 6;									/* 6 */
-	}	
-	else if((ButtonAdcValue >= 3041) && (ButtonAdcValue <= 3530))
-	{
-		S_VAL = 7;									/* 7 */
-	}	
-	else if((ButtonAdcValue >= 3531) && (ButtonAdcValue <= 4020))
-	{
-		S_VAL = 8;									/* 8 */
-	}	
-	else if((ButtonAdcValue >= 4021) && (ButtonAdcValue <= 4096))
-	{
-		S_VAL = 9;									/* 9 */
-	}	
-	return S_VAL;
+}
+
+/*
+*********************************************************************************************************
+*	  : GetButtonGear
+*	˵: ȡȷϵĵλλ仯˵λδ仯
+*	    : uint8_t *gear S1~S6λBUTTON_NUM
+*	  ֵ: λȷϱ仯0Ϊδ
+*********************************************************************************************************
+*/
+uint16_t GetButtonGear(uint8_t *gear)
+{
+	memcpy(gear, buttonDecode.gear, sizeof(buttonDecode.gear));
+	return buttonDecode.chgSeq;
 }
 
 
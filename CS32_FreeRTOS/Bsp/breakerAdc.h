@@ -1,6 +1,9 @@
 #ifndef BREAKER_ADC_H
 #define BREAKER_ADC_H
 
+#include <stdint.h>
+#include <stdbool.h>
+
 typedef enum
 {
 	BUTTON_0_IDX,						/* λ0 ID			0 */
@@ -36,25 +39,71 @@ typedef enum
      *    8 					3531 ~ 4020						   2.845279V ~ 3.239316V
      *	  9						4021 ~ 4096						   3.240121V ~ 3.3V
 	*/
+#define BUTTON_NUM					(BUTTON_5_IDX+1)	/* λ */
+#define BUTTON_GEAR_OFF_MAX			100					/* OFF */
+#define BUTTON_GEAR_STEP			490					/* 1~9ÿ */
+#define BUTTON_GEAR_STEP_RECIP		2140				/* 2^20/BUTTON_GEAR_STEPȡԳ˷ */
+#define BUTTON_GEAR_RECIP_SHIFT		20
+
+/* λλ룺εɨֵƽλزµλBUTTON_SETTLE_MSȷϡ
+ * ɨĸŻBUTTON_AVER_NUMƽֵг֣ť絵תʱƽֵм䵵λBUTTON_AVER_NUM-1Σ
+ * ȷϴBUTTON_AVER_NUMͬʱ˳ */
+#define BUTTON_AVER_SHIFT			2
+#define BUTTON_AVER_NUM				(1<<BUTTON_AVER_SHIFT)	/* ƽɨ */
+#define BUTTON_HYST					30		/* λ߽ز(ֵ)Լ24mVСڵһ */
+#define BUTTON_SETTLE_MS			500		/* λȷʱ */
+#define BUTTON_SETTLE_SCANS			(BUTTON_SETTLE_MS*ADC_SLOW_SCAN_FREQ/1000)
 
 
 
 #define BREAKER_ADC_LOG						0
 
+/* ˮ߷ֶμʱ̽룺SysTickõCPUʱڷֱʵĺʱ׶μ¼С//ƽֵ
+ * ʵ׶ִʱ䣻0ʱ̽ȫȥ */
+#define ADC_PROBE_EN						0
+#define ADC_PROBE_DUMP_CMD					'p'		/* Դ̽ͳƵ */
 
-#define PHASE_FREQ							50
-#define PHASE_PERIOD_WINDOW_DIV				1//4
-#define AN_COUNT_FREQ						(PHASE_FREQ*PHASE_PERIOD_WINDOW_DIV)
+#define PHASE_FREQ							50		/* ȱʡƵƵʣϵ簴òʣ֮ɹƵʸٵ */
+#define PHASE_FREQ_MIN						45		/* ƵʸٷΧ50Hz/60Hz */
+#define PHASE_FREQ_MAX						65
+#define NPT									64		/* ÿƵڣͨĲ */
+#define FS									(PHASE_FREQ*NPT)	/* ͨȱʡƵʣTIM1Ƶ */
+#define PHASE_PERIOD_WINDOW_DIV				2		/* ڻڣDMA봫/жϸһֵÿƵڸ */
+#define AN_COUNT_FREQ						(phaseFreq*PHASE_PERIOD_WINDOW_DIV)	/* ÿٵĵƵʱ仯ֵTIM1 */
 
 #define AN_AVER_COUNT						1//(AN_COUNT_FREQ/4)
 
 
+#define RMS_FRAC_BITS		4		/* ĶСλQ41/16ADCֵֵQ4ͬ */
+#define IABC_PHASE_NUM		3		/* ABC˳Ÿֵ */
+
 #define PHASE_A_BITMASK		((uint8_t)(1<<0))
 #define PHASE_B_BITMASK		((uint8_t)(1<<1))
 #define PHASE_C_BITMASK		((uint8_t)(1<<2))
 #define PHASE_N_BITMASK 	((uint8_t)(1<<3))
 
 
+/* ǰ׼0-׼룬У׼ֱ߰ľֵϣ1-еƫ룬ȥֱƫúУ׼ */
+#define CURR_SAMPLE_DC_REMOVE	0
+
+/* ADCʲͨTIM1ʱDMAˣλԴͨѯ */
+#define ADC_FAST_CHANLS_NUM		(IA_IDX-IC_IDX+1)		/* ͨIC,IB,IAͨɨ */
+#define ADC_FAST_COL(idx)		((idx)-IC_IDX)			/* ͨDMAһеλ */
+#define ADC_SLOW_CHANLS_NUM		(POWER_IDX+1)			/* ͨλ0~5Դ */
+#define ADC_SLOW_SCAN_FREQ		10						/* ͨɨƵ */
+
+/* DMAѭ֡ */
+#define ADC_DMA_HALF_FIRST		0	/* 봫жϣǰ֡ȶ */
+#define ADC_DMA_HALF_SECOND		1	/* жϣ֡ȶ */
+#define ADC_FRAME_CATCHUP_MAX	10	/* ֡󰴱ֵ֡㱣֡(100ms)ͣ(ͣ)ֻ */
+
+/* GoertzelгÿƵڼ2357г */
+#define FFT_HARM_NUM			4		/* г */
+
+/* ̨FFTгȼԸһڵĿ64FFT */
+#define FFT_SPEC_NUM			15		/* Ƶ1~15 */
+#define FFT_TASK_PERIOD_MS		20		/* FFTÿһóʱ */
+
 /* curr mode */
 #define CURR_MODE_BIG		0
 #define CURR_MODE_SMALL		1
@@ -69,10 +118,20 @@ typedef enum
 
 typedef struct
 {
-	float dcAn;
-	float acAn;					/* 洢ľֵ */
-	uint32_t fn;
-	uint16_t angle; 
+	float dcAn;					/* ֱֵ */
+	float acAn;					/* 洢ľֵ(ȥֱ) */
+	float rmsAn;				/* ֱľֵ */
+	uint32_t msQ8;				/* У׼ľֵ(ADCֵQ8)У׼ǰֵƽ */
+	uint32_t fn;				/* Чֵ(ADCֵQ4) */
+	uint16_t angle; 			/* λԱڵһ㣬λ0.1(0~3599) */
+	uint16_t harm[FFT_HARM_NUM];	/* 2357гǧֱ */
+	uint16_t thd;				/* г(2~15)ǧֱȣ̨FFT */
+	uint16_t spec[FFT_SPEC_NUM];	/* 1~15гЧֵ(ADCֵQ4)̨FFT */
+	uint16_t maxVal;			/* ֵ */
+	uint16_t minVal;			/* Сֵ */
+	uint16_t posPeak;			/* ֵֵ-ֱ */
+	uint16_t negPeak;			/* ֱֵ-Сֵ */
+	uint16_t ampEst;			/* ҷֵƣ֡ھȷϵֵ */
 }FFTParasDef;
 
 typedef struct
@@ -89,11 +148,15 @@ typedef struct
 	PhaseInfoDef ic; 
 }BreakerFftDef;
 
+/* жADCֵУֵñ仯ʱУ׼ΪֵÿֻȽϣ
+ * ֵ(A)ʾ¼ʱGetParaAn軻 */
 typedef struct
 {
-	float an;
-	float anAver;
-	float anSum;
+	uint32_t msQ8;				/* У׼ADCֵ(Q8) */
+	uint32_t msFastQ8;			/* ڷֵADCֵ(Q8)ϺԼ2.5msɷӳ */
+	uint64_t msSum;
+	uint32_t msAver;
+	uint8_t idx;				/* ͨIDֵʱѡУ׼ϵ */
 }breakerParaDef;
 
 typedef struct
@@ -105,6 +168,71 @@ typedef struct
 	uint32_t 	periodIdx;
 }BreakerParaInfoDef;
 
+typedef struct
+{
+	uint32_t seq;				/* ֡ţð֡ʱDMA֡ */
+	uint32_t usStamp;			/* ð֡ʱ(us) */
+	uint8_t isBusy;				/* ڶȡð֡ */
+	uint8_t isOverrun;			/* ȡڼDMAѿʼǸð֡ */
+}AdcDmaHalfDef;
+
+typedef struct
+{
+	uint32_t frameSeq;			/* DMAɴİ֡ */
+	uint32_t procSeq;			/* һδİ֡ */
+	uint32_t dropCnt;			/* ʱδİ֡ */
+	uint32_t overrunCnt;		/* ȡڼ䱻DMAǶİ֡ */
+	uint32_t catchUpCnt;		/* ֡󰴱ֵ֡㱣İ֡ */
+	uint32_t slowScanFailCnt;	/* ɨȴADCֹͣʱĴ */
+	uint32_t harmCycles;		/* һгʱ(CPUʱ) */
+	uint32_t harmCyclesMax;		/* гʱ(CPUʱ) */
+}AdcFrameStatDef;
+
+/* ʱ̽׶Σһ֡ڰ˳Уÿ׶εĺʱΪһ̽㵽̽ʱ */
+typedef enum
+{
+	ADC_PROBE_SUM_STAT,				/* ۼӺ/ƽ/ֵͳ() */
+	ADC_PROBE_AMP_EST,				/* ڷֵ */
+	ADC_PROBE_HARM,					/* Goertzelг */
+	ADC_PROBE_FREQ_TRACK,			/*  */
+	ADC_PROBE_FFT_SNAP,				/* ̨FFTڿ */
+	ADC_PROBE_AN_COUNT,				/* ھֵ/Чֵϳ */
+	ADC_PROBE_HARM_PUB,				/* г㼰 */
+	ADC_PROBE_FREQ_ADJUST,			/* Ƶʸٵʼֵͳ */
+	ADC_PROBE_KNOB,					/* λλ */
+	ADC_PROBE_QUIESCENT,			/* ֹжϼ· */
+	ADC_PROBE_SETTING,				/* ֵˢ¼У׼ */
+	ADC_PROBE_WARNING,				/* Ԥ */
+	ADC_PROBE_INSTANT,				/* ·˲ʱ */
+	ADC_PROBE_SHORT_DELAY,			/* ·ʱ */
+	ADC_PROBE_LONG_DELAY,			/* سʱ */
+	ADC_PROBE_FRAME,				/* ֡ϸ׶ */
+	ADC_PROBE_LOG,					/* Ϣӡ */
+
+	ADC_PROBE_NUM
+}AdcProbeEnum;
+
+typedef struct
+{
+	uint32_t minCycles;				/* Сʱ(CPUʱ) */
+	uint32_t maxCycles;				/* ʱ */
+	uint32_t sumCycles;				/* ʱۼӺͣʱͬʱ */
+	uint32_t cnt;					/* ۼӴ */
+}AdcProbeDef;
+
+#if ADC_PROBE_EN
+#define ADC_PROBE_START()			AdcProbeStart()
+#define ADC_PROBE_LAP(id)			AdcProbeLap(id)
+#define ADC_PROBE_TOTAL(id)			AdcProbeTotal(id)
+#else
+#define ADC_PROBE_START()
+#define ADC_PROBE_LAP(id)
+#define ADC_PROBE_TOTAL(id)
+#endif
+
+extern BreakerFftDef BreakerFft;
+extern uint16_t phaseFreq;
+
 
 
 
@@ -117,6 +245,29 @@ void StartAdcDmaInit(void);
 
 void StartAdcConvert(void);
 void StopAdcConvert(void);
+void AdcDmaXferCpltCallback(uint8_t half);
+void GetAdcFrameStat(AdcFrameStatDef *stat);
+uint32_t GetAdcFrameUs(void);
+void AdcProbeStart(void);
+void AdcProbeLap(uint8_t id);
+void AdcProbeTotal(uint8_t id);
+void PrintAdcProbe(void);
+uint16_t GetPhaseFreq(void);
+void BreakerFftProc(void);
+uint16_t GetPhaseFreqX100(void);
+
+void AdcWatchdogConfig(bool isEnable, uint16_t high);
+void AdcWatchdogIrqHandler(void);
+bool IsAdcWatchdogTripped(void);
+void ClrAdcWatchdogTripped(void);
+float CountAnRawRms(uint8_t idx, float an);
+void CalibLutInit(void);
+uint32_t CountCalibAnQ4(uint8_t idx, uint32_t rawQ4);
+float CountCalibAn(uint8_t idx, uint32_t rawQ4);
+float CountMsAn(uint8_t idx, uint32_t msQ8);
+float GetParaAn(const breakerParaDef *para);
+uint32_t GetParaAnQ4(const breakerParaDef *para);
+uint32_t CountAnRawMsQ8(uint8_t idx, float an);
 
 float GetIaA(void);
 float GetIbA(void);
@@ -131,6 +282,7 @@ float GetIbAver(void);
 float GetIcAver(void);
 
 uint8_t ButtonGearConvert(uint32_t Value);
+uint16_t GetButtonGear(uint8_t *gear);
 
 void BreakerAdcInit(void);
 void BreakerAdcProc(void);
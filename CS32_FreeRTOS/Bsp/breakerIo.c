@@ -1,20 +1,30 @@
 #include "bsp.h"
 
+static volatile uint32_t tkOnUs = 0;							/* ѿȦһͨʱ(us) */
 
 
 /*
 *********************************************************************************************************
 *	  : TkOn
-*	˵: PB13-BREAKߵƽѿ۶
+*	˵: PB13-BREAKߵƽѿ۶ȦɶϵתΪͨʱ¼ʱ
 *	    : 
 *	  ֵ: 
 *********************************************************************************************************
 */
 void TkOn(void)
 {
+	if(0 == (GPIOB->DO & TK_CONTROL_PIN))
+	{
+		tkOnUs = GetUsStamp();
+	}
     gpio_bits_set(GPIOB,TK_CONTROL_PIN);	
 }
 
+uint32_t GetTkOnUs(void)
+{
+	return tkOnUs;
+}
+
 /*
 *********************************************************************************************************
 *	  : TkOff
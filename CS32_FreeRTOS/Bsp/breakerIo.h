@@ -6,6 +6,7 @@
 
 void TkOn(void);												/* PB13-BREAKߵƽѿ۶ */
 void TkOff(void);												/* PB13-BREAK͵ƽͨѿ */
+uint32_t GetTkOnUs(void);										/* ѿȦһͨʱ(us) */
 
 void cs_start_power_on(void);									/* PB14͵ƽԴ·Ӳ */
 void cs_start_power_off(void);									/* PB14ߵƽԴ· */
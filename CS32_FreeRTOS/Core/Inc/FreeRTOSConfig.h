@@ -50,6 +50,7 @@
 #if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
   #include <stdint.h>
   extern uint32_t SystemCoreClock;
+  uint32_t GetUsStamp(void);
   void xPortSysTickHandler(void);
 #endif
 #define configUSE_PREEMPTION                     1					        	/* ʹռʽ */
@@ -74,6 +75,12 @@
 #define configTIMER_QUEUE_LENGTH                 10						        /* ʱеĳ */
 #define configTIMER_TASK_STACK_DEPTH             256					        /* ʱջռĴС*/
 
+/* ʱͳƣʱΪTIM31usʱ(bsp_Init)ͳCPU */
+#define configUSE_TRACE_FACILITY                 1					        	/* ʹuxTaskGetSystemStateѯ״̬ */
+#define configGENERATE_RUN_TIME_STATS            1					        	/* ʹʱͳ */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()         GetUsStamp()
+
 
 
 /* Co-routine definitions. */
@@ -90,6 +97,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelayUntil             0
 #define INCLUDE_vTaskDelay                  1
 #define INCLUDE_xTaskGetSchedulerState      1
+#define INCLUDE_xTaskGetIdleTaskHandle      1
 
 /* Normal assert() semantics without relying on the provision of an assert.h
 header file. */
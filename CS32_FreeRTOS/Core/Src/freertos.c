@@ -29,8 +29,72 @@
 
 osThreadId TaskAdcHandle;
 void StartTaskAdc(void const * argument);
+#define TASK_ADC_STACK_SIZE		256									/* ADCջλ֣FreeRTOSѷ */
+
+#define TASK_FFT_STACK_SIZE		96									/* ̨FFTջλ */
+osThreadId TaskFftHandle;
+static StaticTask_t xTaskFftTCBBuffer;
+static StackType_t xTaskFftStack[TASK_FFT_STACK_SIZE];
+void StartTaskFft(void const * argument);
 void MX_FREERTOS_Init(void); 								/* ߳ʼ */
 
+/* ϵͳӣڶʱȡ״̬ͳCPUɼջ */
+#define SYS_MON_PERIOD_MS		1000								/* ڣCPUɵĶ̴ */
+#define SYS_MON_TASK_MAX		6									/* ɼӵ */
+
+/* CPUɣɸʱ(us)1sһ60sڵĸɣΪ1-ʱռȡ
+ * 1sֵֵԴڶȡ */
+#define CPU_LOAD_LONG_NUM		60									/* ڰļ */
+#define CPU_LOAD_DUMP_CMD		'c'									/* ԴCPUɵ */
+
+/* ڴջʷСʣ༰ʷСʣʱϱһθ澯¼ջѿĿռ */
+#define MEM_STACK_MARGIN_MIN	32									/* ջޣλ */
+#define MEM_HEAP_MARGIN_MIN		128									/* ޣλֽ */
+#define MEM_WARN_HEAP_BIT		(1<<SYS_MON_TASK_MAX)				/* 澯־жѵλãλӦ */
+#define MEM_RAM_SIZE			(8*1024)							/* ƬRAMɢļRW_IRAM1һ */
+#define MEM_MAP_DUMP_CMD		'm'									/* Դڴֲ */
+
+typedef struct
+{
+  TaskHandle_t handle;
+  const char *name;
+  uint32_t runPre;													/* һĩۼʱ(us) */
+  uint16_t load;													/* 1sʱռȣǧֱ */
+  uint16_t stackSize;												/* ջСλ֣0Ϊδ֪ */
+  uint16_t stackFree;												/* ջʷСʣ࣬λ */
+}SysMonTaskDef;
+
+typedef struct
+{
+  uint32_t stampPre;												/* һĩʱ(us) */
+  uint32_t idlePre;													/* һĩۼʱ(us) */
+  uint32_t longStamp;												/*  */
+  uint32_t longIdle;
+  uint8_t longCnt;													/* ۼƵ */
+  uint8_t isValid;													/* һڵ */
+  uint16_t load1s;													/* 1sɣǧֱ */
+  uint16_t load60s;													/* һ60sڵĸɣǧֱ */
+  uint16_t loadMax;													/* 1sֵȡ */
+}CpuLoadDef;
+
+typedef struct
+{
+  uint16_t heapFree;												/* ѵǰʣ࣬λֽ */
+  uint16_t heapMinFree;												/* ʷСʣ */
+  uint8_t warnMask;													/* ϱ澯ĶMEM_WARN_HEAP_BIT(1<<)λ */
+}MemMonDef;
+
+STATIC_ASSERT(SYS_MON_TASK_MAX < 8, mem_warn_mask_bits);
+
+static SysMonTaskDef sysMonTask[SYS_MON_TASK_MAX];
+static CpuLoadDef cpuLoad;
+static MemMonDef memMon;
+static void SysMonTimerCallback(void const *argument);
+static osStaticTimerDef_t sysMonTimerCB;
+osTimerStaticDef(SysMonTimer, SysMonTimerCallback, &sysMonTimerCB);
+static void PrintCpuLoad(void);
+static void PrintMemMap(void);
+
 
 
 
@@ -84,13 +148,23 @@ void MX_FREERTOS_Init(void)
 
 
   /* definition and creation of TaskAdc */
-  osThreadDef(TaskAdc, StartTaskAdc, osPriorityAboveNormal, 0, 256);
+  osThreadDef(TaskAdc, StartTaskAdc, osPriorityAboveNormal, 0, TASK_ADC_STACK_SIZE);
   TaskAdcHandle = osThreadCreate(osThread(TaskAdc), NULL);
 
+  /* ̨гûȼջƿ龲̬䲻ռFreeRTOS */
+  osThreadStaticDef(TaskFft, StartTaskFft, osPriorityLow, 0, TASK_FFT_STACK_SIZE, xTaskFftStack, &xTaskFftTCBBuffer);
+  TaskFftHandle = osThreadCreate(osThread(TaskFft), NULL);
+
+  /* CPUɼڴͳڶʱн */
+  osTimerStart(osTimerCreate(osTimer(SysMonTimer), osTimerPeriodic, NULL), SYS_MON_PERIOD_MS);
+
 }
 
 void StartTaskAdc(void const * argument)
 {
+  uint8_t printDiv = 0;
+  int16_t cmd = 0;
+
   #if 0
   WdgMonitorInit();
   #endif
@@ -100,15 +174,289 @@ void StartTaskAdc(void const * argument)
 	
   for(;;)
   {
-    adc_conversion_start(ADC1);
     BreakerAdcProc();
     IwdgFeed();
+    /* ԴڲѯѿʱӡCPUɡڴֲˮ߼ʱͳ */
+    cmd = UsartCmdGet();
+    if(TRIP_LAT_DUMP_CMD == cmd)
+    {
+      PrintTripLat();
+    }
+    else if(CPU_LOAD_DUMP_CMD == cmd)
+    {
+      PrintCpuLoad();
+    }
+    else if(MEM_MAP_DUMP_CMD == cmd)
+    {
+      PrintMemMap();
+    }
+    #if ADC_PROBE_EN
+    else if(ADC_PROBE_DUMP_CMD == cmd)
+    {
+      PrintAdcProbe();
+    }
+    #endif
     #if 1
-    PrintSysInfo();
+    /* ÿƵڴӡһΣڵļƵ޹ */
+    if(++printDiv >= PHASE_PERIOD_WINDOW_DIV)
+    {
+      printDiv = 0;
+      ADC_PROBE_START();
+      PrintSysInfo();
+      ADC_PROBE_LAP(ADC_PROBE_LOG);
+    }
     #endif
   }
 }
 
+void StartTaskFft(void const * argument)
+{
+  for(;;)
+  {
+    BreakerFftProc();
+    osDelay(FFT_TASK_PERIOD_MS);
+  }
+}
+
+/*
+*********************************************************************************************************
+*	  : CpuRunPermille
+*	˵: ʱռڳȵǧֱȣڳԼ71ӵ1/1000ʱС˷
+*	    : uint32_t run   ʱ(us)
+*			   uint32_t total ڳ(us)
+*	  ֵ: ǧֱ
+*********************************************************************************************************
+*/
+static uint16_t CpuRunPermille(uint32_t run, uint32_t total)
+{
+  if(run >= total)
+  {
+    return 1000;
+  }
+  if(total > UINT32_MAX/1000)
+  {
+    return (uint16_t)(run/(total/1000));
+  }
+  return (uint16_t)(run*1000/total);
+}
+
+/*
+*********************************************************************************************************
+*	  : SysMonStackSize
+*	˵: ѯ񴴽ʱõջС
+*	    : TaskHandle_t handle 
+*	  ֵ: ջСλ֣ǱļΪ0
+*********************************************************************************************************
+*/
+static uint16_t SysMonStackSize(TaskHandle_t handle)
+{
+  if(handle == (TaskHandle_t)TaskAdcHandle)
+  {
+    return TASK_ADC_STACK_SIZE;
+  }
+  if(handle == (TaskHandle_t)TaskFftHandle)
+  {
+    return TASK_FFT_STACK_SIZE;
+  }
+  if(handle == xTaskGetIdleTaskHandle())
+  {
+    return configMINIMAL_STACK_SIZE;
+  }
+  if(handle == xTimerGetTimerDaemonTaskHandle())
+  {
+    return configTIMER_TASK_STACK_DEPTH;
+  }
+  return 0;
+}
+
+/*
+*********************************************************************************************************
+*	  : CpuLoadCount
+*	˵: ɿۼʱ1sɣÿCPU_LOAD_LONG_NUMڼһγڸ
+*	    : uint32_t idle  ۼʱ(us)
+*			   uint32_t stamp ĩʱ(us)
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void CpuLoadCount(uint32_t idle, uint32_t stamp)
+{
+  if(cpuLoad.isValid)
+  {
+    cpuLoad.load1s = 1000 - CpuRunPermille(idle - cpuLoad.idlePre, stamp - cpuLoad.stampPre);
+    portENTER_CRITICAL();
+    if(cpuLoad.load1s > cpuLoad.loadMax)
+    {
+      cpuLoad.loadMax = cpuLoad.load1s;
+    }
+    portEXIT_CRITICAL();
+    if(++cpuLoad.longCnt >= CPU_LOAD_LONG_NUM)
+    {
+      cpuLoad.load60s = 1000 - CpuRunPermille(idle - cpuLoad.longIdle, stamp - cpuLoad.longStamp);
+      cpuLoad.longCnt = 0;
+    }
+  }
+  if(!cpuLoad.isValid || (0 == cpuLoad.longCnt))
+  {
+    cpuLoad.longStamp = stamp;
+    cpuLoad.longIdle = idle;
+  }
+  cpuLoad.stampPre = stamp;
+  cpuLoad.idlePre = idle;
+  cpuLoad.isValid = 1;
+}
+
+/*
+*********************************************************************************************************
+*	  : MemMonCount
+*	˵: ˢ¶ջѵʷСʣ࣬µ޵Ķϱһθ澯¼
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void MemMonCount(void)
+{
+  uint8_t warnMask = 0;
+  uint8_t k = 0;
+
+  memMon.heapFree = (uint16_t)xPortGetFreeHeapSize();
+  memMon.heapMinFree = (uint16_t)xPortGetMinimumEverFreeHeapSize();
+  if(memMon.heapMinFree < MEM_HEAP_MARGIN_MIN)
+  {
+    warnMask |= MEM_WARN_HEAP_BIT;
+  }
+  for(k=0; (k<SYS_MON_TASK_MAX) && (NULL != sysMonTask[k].handle); k++)
+  {
+    if(sysMonTask[k].stackFree < MEM_STACK_MARGIN_MIN)
+    {
+      warnMask |= (1<<k);
+    }
+  }
+  /* ʷСֵÿֻϱһ */
+  if(warnMask & ~memMon.warnMask)
+  {
+    memMon.warnMask |= warnMask;
+    BreakerWarnEvtReport(SWITCH_WARN_REASON_MEM_LOW);
+  }
+}
+
+/*
+*********************************************************************************************************
+*	  : SysMonTimerCallback
+*	˵: ڶʱصȡۼʱ估ջʷСʣ(ͬuxTaskGetStackHighWaterMark)1s
+*			  ռȡCPUɼڴۼʱ估ʱֵ㣬32λƲӰ
+*	    : argument δʹ
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void SysMonTimerCallback(void const *argument)
+{
+  TaskStatus_t status[SYS_MON_TASK_MAX];
+  TaskHandle_t idleHandle = xTaskGetIdleTaskHandle();
+  SysMonTaskDef *task = NULL;
+  uint32_t stamp = 0;
+  uint32_t idle = 0;
+  UBaseType_t num = 0;
+  UBaseType_t i = 0;
+  uint8_t k = 0;
+
+  num = uxTaskGetSystemState(status, SYS_MON_TASK_MAX, &stamp);
+  if(0 == num)
+  {
+    return;															/* SYS_MON_TASK_MAX */
+  }
+  for(i=0; i<num; i++)
+  {
+    if(idleHandle == status[i].xHandle)
+    {
+      idle = status[i].ulRunTimeCounter;
+    }
+    /* ƥ䣬״γֵռһλ */
+    for(k=0; k<SYS_MON_TASK_MAX; k++)
+    {
+      task = &sysMonTask[k];
+      if((status[i].xHandle == task->handle) || (NULL == task->handle))
+      {
+        break;
+      }
+    }
+    if(NULL == task->handle)
+    {
+      task->handle = status[i].xHandle;
+      task->name = status[i].pcTaskName;
+      task->stackSize = SysMonStackSize(status[i].xHandle);
+    }
+    else if(status[i].xHandle == task->handle)
+    {
+      task->load = CpuRunPermille(status[i].ulRunTimeCounter - task->runPre, stamp - cpuLoad.stampPre);
+    }
+    else
+    {
+      continue;
+    }
+    task->runPre = status[i].ulRunTimeCounter;
+    task->stackFree = status[i].usStackHighWaterMark;
+  }
+
+  CpuLoadCount(idle, stamp);
+  MemMonCount();
+}
+
+/*
+*********************************************************************************************************
+*	  : PrintCpuLoad
+*	˵: CPUɼ1sʱռȣֵ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void PrintCpuLoad(void)
+{
+  CpuLoadDef load;
+  uint8_t k = 0;
+
+  /* ʱȼڱͳƿڸ;ϣֵĶȡȽϸ¾ٽڽ */
+  portENTER_CRITICAL();
+  load = cpuLoad;
+  cpuLoad.loadMax = 0;
+  portEXIT_CRITICAL();
+
+  printf("[Cpu]:1s %d.%d%%\t60s %d.%d%%\tmax %d.%d%%\r\n", load.load1s/10, load.load1s%10,
+    load.load60s/10, load.load60s%10, load.loadMax/10, load.loadMax%10);
+  for(k=0; (k<SYS_MON_TASK_MAX) && (NULL != sysMonTask[k].handle); k++)
+  {
+    printf("  %-16s %d.%d%%\r\n", sysMonTask[k].name, sysMonTask[k].load/10, sysMonTask[k].load%10);
+  }
+}
+
+/*
+*********************************************************************************************************
+*	  : PrintMemMap
+*	˵: RAMֲͳƵѳʼ(.data)ʼ(.bss)FreeRTOSѼջ
+*			  ĴСʷСʣ(ֽ)Ŀļϸɵmapļ
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+static void PrintMemMap(void)
+{
+  extern uint8_t Image$$RW_IRAM1$$RW$$Length[];
+  extern uint8_t Image$$RW_IRAM1$$ZI$$Length[];
+  uint32_t dataSize = (uint32_t)Image$$RW_IRAM1$$RW$$Length;
+  uint32_t bssSize = (uint32_t)Image$$RW_IRAM1$$ZI$$Length;
+  const SysMonTaskDef *task = NULL;
+  uint8_t k = 0;
+
+  printf("[Ram]:data %lu\tbss %lu\tfree %lu\t(of %d)\r\n", dataSize, bssSize, MEM_RAM_SIZE - dataSize - bssSize, MEM_RAM_SIZE);
+  printf("  %-16s size %d\tmin free %d\tfree %d%s\r\n", "heap", configTOTAL_HEAP_SIZE, memMon.heapMinFree, memMon.heapFree,
+    (memMon.warnMask & MEM_WARN_HEAP_BIT) ? "\tLOW" : "");
+  for(k=0; (k<SYS_MON_TASK_MAX) && (NULL != sysMonTask[k].handle); k++)
+  {
+    task = &sysMonTask[k];
+    printf("  %-16s size %d\tmin free %d%s\r\n", task->name, (int)(task->stackSize*sizeof(StackType_t)),
+      (int)(task->stackFree*sizeof(StackType_t)), (memMon.warnMask & (1<<k)) ? "\tLOW" : "");
+  }
+}
+
 
 
 
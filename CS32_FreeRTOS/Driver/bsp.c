@@ -76,6 +76,9 @@ void bsp_Init(void)
 	
 	/* ADCöʱʼ */
 	StartAdcTimInit();
+
+	/* usʱʱʼ */
+	StartUsStampTimInit();
 	
     /* ADCʼ */
 	StartAdcInit();	
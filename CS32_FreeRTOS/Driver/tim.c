@@ -53,11 +53,12 @@ void StartAdcTimInit(void)
     tim_compare_struct_init(&timer_compare_struct);
 
 	/* TimeOut = ((Prescaler + 1) * (Period + 1)) / TimeClockFren = (15000 * 1) / 48000000 = 0.3125ms */
-    timer_config_struct.time_period = 30000-1;				//15000-1 -> 64    60000-1 -> 16
+    timer_config_struct.time_period = ADC_TRIG_TIM_CLK/FS-1;	//15000-1 -> 64    30000-1 -> 32
     timer_config_struct.time_divide = 0x0;
     timer_config_struct.clock_divide = 0x0;
     timer_config_struct.count_mode = TIM_COUNT_PATTERN_UP;  
     tim_timer_config(TIM1, &timer_config_struct);
+    tim_uval_shadow_config(TIM1, ENABLE);		/* ֵԤװأƵʸ޸ʱһθ¼Чë */
 
     timer_compare_struct.time_mode = TIM_CHxOCMSEL_PWM1;
     timer_compare_struct.output_state = TIM_CHx_OUTPUT_ENABLE;
@@ -100,3 +101,76 @@ void StopAdcTrigTimer(void)
 }
 
 
+
+/*
+*********************************************************************************************************
+*	  : SetAdcTrigTimPeriod
+*	˵: ޸TIM1ֵADCڸٵƵʹNPTǡøһƵ
+*	    : uint32_t period ֵΪ(period+1)TIM1ʱ
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void SetAdcTrigTimPeriod(uint32_t period)
+{
+	tim_counter_update_set(TIM1, period);
+}
+
+/*
+*********************************************************************************************************
+*	  : GetAdcTrigTimPeriod
+*	˵: ȡTIM1ǰֵ
+*	    : 
+*	  ֵ: ֵ
+*********************************************************************************************************
+*/
+uint32_t GetAdcTrigTimPeriod(void)
+{
+	return TIM1->UVAL;
+}
+
+/*
+*********************************************************************************************************
+*	  : StartUsStampTimInit
+*	˵: TIM3Ϊ1MHzе16λΪusʱʱʹж
+*	    : 
+*	  ֵ: 
+*********************************************************************************************************
+*/
+void StartUsStampTimInit(void)
+{
+    timer_config_t  timer_config_struct;
+
+    rcu_apb1_periph_clock_enable_ctrl(RCU_APB1_PERI_TIM3, ENABLE);
+
+    tim_def_init(TIM3);
+    tim_config_struct_init(&timer_config_struct);
+    timer_config_struct.time_period = 0xFFFF;
+    timer_config_struct.time_divide = SystemCoreClock/US_STAMP_TIM_CLK - 1;		/* APBʱӼϵͳʱ */
+    timer_config_struct.clock_divide = 0x0;
+    timer_config_struct.count_mode = TIM_COUNT_PATTERN_UP;
+    tim_timer_config(TIM3, &timer_config_struct);
+    tim_enable_ctrl(TIM3, ENABLE);
+}
+
+/*
+*********************************************************************************************************
+*	  : GetUsStamp
+*	˵: ȡ32λusʱTIM316λֵչԼ71ӻơεüС65.5ms
+*			  ADC DMA֡жÿڵһμɱ֤жоɵ
+*	    : 
+*	  ֵ: ʱ(us)
+*********************************************************************************************************
+*/
+uint32_t GetUsStamp(void)
+{
+	static uint32_t usStamp = 0;
+	UBaseType_t mask = 0;
+	uint32_t stamp = 0;
+
+	mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	usStamp += (uint16_t)(tim_counter_get(TIM3) - usStamp);
+	stamp = usStamp;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+
+	return stamp;
+}
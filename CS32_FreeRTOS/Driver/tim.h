@@ -1,9 +1,18 @@
 #ifndef __TIM_H__
 #define __TIM_H__
 
+#include <stdint.h>
+
+#define ADC_TRIG_TIM_CLK		48000000		/* TIM1ʱӣƵ */
+#define US_STAMP_TIM_CLK		1000000			/* TIM3ʱӣ1usֱʵʱ */
+
 void StartAdcTimInit(void);
 void StartAdcTrigTimer(void);
 void StopAdcTrigTimer(void);
+void SetAdcTrigTimPeriod(uint32_t period);
+uint32_t GetAdcTrigTimPeriod(void);
+void StartUsStampTimInit(void);
+uint32_t GetUsStamp(void);
 
 
 
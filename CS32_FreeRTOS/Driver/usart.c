@@ -66,6 +66,27 @@ void cs_start_usart_nvic_config(void)
     usart_interrupt_config(USART1, USART_INT_RXNE, ENABLE); // Enable the USART receive interrupt
 }
 
+/*
+*********************************************************************************************************
+*	  : UsartCmdGet
+*	˵: ѯԴǷյֽʹýж
+*	    : 
+*	  ֵ: յֽڣʱΪ-1
+*********************************************************************************************************
+*/
+int16_t UsartCmdGet(void)
+{
+	if(SET == usart_flag_status_get(USART1, USART_FLAG_OVRERRF))
+	{
+		usart_flag_clear(USART1, USART_FLAG_OVRERRF);
+	}
+	if(RESET == usart_flag_status_get(USART1, USART_FLAG_RXNE))
+	{
+		return -1;
+	}
+	return (int16_t)(usart_data_recv(USART1) & 0xFF);
+}
+
 /**
   * @brief  Retargets the C library printf function to the USART.
   * @param  None
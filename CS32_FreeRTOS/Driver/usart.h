@@ -1,10 +1,13 @@
 #ifndef __USART_H__
 #define __USART_H__
 
+#include <stdint.h>
+
 
 
 void StartUsartInit(void);
 void cs_start_usart_nvic_config(void);
+int16_t UsartCmdGet(void);
 
 #endif 
 
@@ -0,0 +1,10 @@
+/* RTEãʹܹ̼õHALģͷļ */
+#define RTE_DEVICE_HAL_ADC
+#define RTE_DEVICE_HAL_DMA
+#define RTE_DEVICE_HAL_GPIO
+#define RTE_DEVICE_HAL_RCU
+#define RTE_DEVICE_HAL_TIM
+#define RTE_DEVICE_HAL_USART
+#define RTE_DEVICE_HAL_MISC
+#define RTE_DEVICE_HAL_FWDT
+#define RTE_DEVICE_HAL_FRAMEWORK
@@ -0,0 +1,63 @@
+/* ͷļṩ̼ͷļõͺͼĴṹӦʵ */
+#ifndef STUB_CS32F0XX_H
+#define STUB_CS32F0XX_H
+#include <stdint.h>
+#define __IO volatile
+#define __I volatile const
+#define __O volatile
+#define __weak __attribute__((weak))
+#define __NVIC_PRIO_BITS 2
+#define UNUSED(x) ((void)(x))
+typedef enum {DISABLE = 0, ENABLE = !DISABLE} enable_state_t;
+typedef enum {RESET = 0, SET = !RESET} bit_status_t;
+typedef enum {ERROR = 0, SUCCESS = !ERROR} error_status_t;
+typedef struct { __IO uint32_t STAT, INTEN, CTR, CFG, CFG2, SMPL, RSV[2], WDT, RSV2, CHANSEL, RSV3[5], OUTDAT; } adc_reg_t;
+typedef struct { __IO uint32_t CHxCTR, CHxNUM, CHxPADDR, CHxMADDR; } dma_channel_reg_t;
+typedef struct { __IO uint32_t MFR, OTR, OSPR, PUPDR, DI, DO, SCR, LCKR, MFL, MFH, CLRR; } gpio_reg_t;
+typedef struct { __IO uint32_t CTR1, CTR2, SMCFG, DIE, STS, SWEVG, CHxCFG1, CHxCFG2, CHxCCTR, CNT, PDIV, UVAL, UVCNT, CH1CVAL, CH2CVAL, CH3CVAL, CH4CVAL; } tim_reg_t;
+typedef struct { __IO uint32_t CTR1; } usart_reg_t;
+typedef struct { __IO uint32_t CTR, CFG; } rcu_reg_t;
+typedef struct { __IO uint32_t CTRL, LOAD, VAL, CALIB; } SysTick_Type;
+typedef struct { __I uint32_t CPUID; __IO uint32_t ICSR; } SCB_Type;
+extern adc_reg_t *ADC1; extern dma_channel_reg_t *DMA1_CHANNEL1; extern gpio_reg_t *GPIOA, *GPIOB;
+extern tim_reg_t *TIM1, *TIM3, *TIM14; extern usart_reg_t *USART1; extern rcu_reg_t *RCU;
+extern SysTick_Type *SysTick; extern SCB_Type *SCB;
+typedef enum { IRQn_DMA1_CHANNEL1 = 9, IRQn_ADC1 = 12, IRQn_TIM1_BRK_UP_TRG_COM = 13, IRQn_TIM3 = 16, IRQn_TIM14 = 19, IRQn_USART1 = 27 } IRQn_Type;
+uint32_t SysTick_Config(uint32_t ticks);
+void __disable_irq(void); void __enable_irq(void);
+extern uint32_t SystemCoreClock;
+/* Ĵλ壺breakerAdc.cֱӲĴĴ룬ϲʵЧ */
+#define SCB_ICSR_PENDSTSET_Msk		(1UL << 26)
+#define ADC_CFG_DMAMODE				(1UL << 1)
+#define ADC_CFG_TRGMODE_0			(1UL << 10)
+#define ADC_CFG_TRGMODE				(3UL << 10)
+#define ADC_CFG_HTRGSEL_0			(1UL << 6)
+#define ADC_CFG_WDGEN				(1UL << 23)
+#define ADC_INTEN_WDEVTIE			(1UL << 7)
+#define ADC_STAT_EOI				(1UL << 1)
+#define ADC_STAT_EOCH				(1UL << 2)
+#define ADC_CHANSEL_CHANSEL0		(1UL << 0)
+#define ADC_CHANSEL_CHANSEL1		(1UL << 1)
+#define ADC_CHANSEL_CHANSEL2		(1UL << 2)
+#define ADC_CHANSEL_CHANSEL3		(1UL << 3)
+#define ADC_CHANSEL_CHANSEL4		(1UL << 4)
+#define ADC_CHANSEL_CHANSEL5		(1UL << 5)
+#define ADC_CHANSEL_CHANSEL6		(1UL << 6)
+#define ADC_CHANSEL_CHANSEL7		(1UL << 7)
+#define ADC_CHANSEL_CHANSEL8		(1UL << 8)
+#define ADC_CHANSEL_CHANSEL9		(1UL << 9)
+#define DMA_CHxCTR_CMPIE			(1UL << 1)
+#define DMA_CHxCTR_HLFIE			(1UL << 2)
+#define DMA_CHxCTR_CIRM				(1UL << 5)
+#define DMA_CHxCTR_MAGM				(1UL << 7)
+#define DMA_CHxCTR_PWDH_0			(1UL << 8)
+#define DMA_CHxCTR_MWDH_0			(1UL << 10)
+#define DMA_CHxCTR_PRIL_1			(1UL << 13)
+#define RCU_AHBEN_DMAEN				(1UL << 0)
+#define RCU_AHBEN_PAEN				(1UL << 17)
+#define RCU_AHBEN_PBEN				(1UL << 18)
+#define RCU_APB2EN_ADCEN			(1UL << 9)
+/* HALͷļнCS32F036breakerAdc.cCS32F030ͬ */
+void adc_watchdog_thresholds_set(adc_reg_t* ptr_adc, uint16_t high, uint16_t low);
+void adc_watchdog_channel_mode_enable_ctrl(adc_reg_t* ptr_adc, enable_state_t enable_flag);
+#endif
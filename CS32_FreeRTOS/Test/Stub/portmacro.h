@@ -0,0 +1,40 @@
+/* FreeRTOSֲٽɲԳṩʵ */
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+#include <stdint.h>
+#define portCHAR char
+#define portFLOAT float
+#define portDOUBLE double
+#define portLONG long
+#define portSHORT short
+#define portSTACK_TYPE uint32_t
+#define portBASE_TYPE long
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+#define portTICK_TYPE_IS_ATOMIC 1
+#define portSTACK_GROWTH (-1)
+#define portTICK_PERIOD_MS ((TickType_t)1000/configTICK_RATE_HZ)
+#define portBYTE_ALIGNMENT 8
+#define portYIELD() vPortYield()
+#define portEND_SWITCHING_ISR(x) if(x) portYIELD()
+#define portYIELD_FROM_ISR(x) portEND_SWITCHING_ISR(x)
+extern void vPortYield(void);
+extern void vPortEnterCritical(void);
+extern void vPortExitCritical(void);
+extern uint32_t ulSetInterruptMaskFromISR(void);
+extern void vClearInterruptMaskFromISR(uint32_t);
+#define portSET_INTERRUPT_MASK_FROM_ISR() ulSetInterruptMaskFromISR()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) vClearInterruptMaskFromISR(x)
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+#define portENTER_CRITICAL() vPortEnterCritical()
+#define portEXIT_CRITICAL() vPortExitCritical()
+#define portTASK_FUNCTION_PROTO(vFunction, pvParameters) void vFunction(void *pvParameters)
+#define portTASK_FUNCTION(vFunction, pvParameters) void vFunction(void *pvParameters)
+#define portNOP()
+#define portINLINE __inline
+#define portFORCE_INLINE inline
+#endif
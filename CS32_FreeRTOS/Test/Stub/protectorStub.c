@@ -0,0 +1,73 @@
+#include "protectorStub.h"
+#include "breaker.h"
+#include "usrLib.h"
+#include <stddef.h>
+
+
+CurrProtectorCfgDef currProtectorCfg;
+CurrPickupMsDef currPickupMs;
+
+const CurrPoleDef currPoleTab[CURR_POLE_NUM] =
+{
+	{offsetof(BreakerParaInfoDef, ia), IA_IDX, PHASE_A_BITMASK},
+	{offsetof(BreakerParaInfoDef, ib), IB_IDX, PHASE_B_BITMASK},
+	{offsetof(BreakerParaInfoDef, ic), IC_IDX, PHASE_C_BITMASK},
+};
+
+uint16_t phaseFreq = 50;
+uint8_t stubTripMask = 0;
+
+uint16_t GetPhaseFreq(void)
+{
+	return phaseFreq;
+}
+
+bool SwitchOffProtector(SwitchWarnReasonEnum reason, uint8_t phase)
+{
+	stubTripMask |= phase;
+	return true;
+}
+
+bool IsFactoryMode(void)
+{
+	return false;
+}
+
+void CurrSettingInvalidate(void)
+{
+}
+
+/* ͬcurrProtector.c */
+bool CurrCountDownRun(CurrCountDownDef *countDown, int32_t total)
+{
+	if(!countDown->isRun)
+	{
+		countDown->isRun = true;
+		countDown->cnt = total;
+		return false;
+	}
+	countDown->cnt--;
+
+	return (countDown->cnt <= 0);
+}
+
+/* У׼ADCֵ(Q4)ֵ(AQ4) */
+uint32_t CountCalibAnQ4(uint8_t idx, uint32_t rawQ4)
+{
+	return rawQ4;
+}
+
+uint32_t GetParaAnQ4(const breakerParaDef *para)
+{
+	return SqrtU32(para->msQ8);
+}
+
+/* ֵ(AQ4)ĳADCֵ(Q8)У׼²4095A */
+void StubParaSet(BreakerParaInfoDef *info, uint8_t pole, uint32_t anQ4)
+{
+	breakerParaDef *para = (breakerParaDef *)((uint8_t *)info + currPoleTab[pole].paraOffset);
+
+	para->msQ8 = anQ4*anQ4;
+	para->msFastQ8 = para->msQ8;
+	para->idx = currPoleTab[pole].adcIdx;
+}
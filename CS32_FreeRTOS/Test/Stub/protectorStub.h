@@ -0,0 +1,16 @@
+#ifndef PROTECTOR_STUB_H
+#define PROTECTOR_STUB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "currProtector.h"
+
+/* ñcurrProtector.cbreaker.cbreakerAdc.cбõĽӿڣ
+ * У׼Ȼ(ADCֵֵ)բǳɹ¼ */
+
+/* phaseFreq(AN_COUNT_FREQȡĵƵʻ)ɱ׮壬ֱӸֵ */
+extern uint8_t stubTripMask;			/* SwitchOffProtector¼Ķ𣬲 */
+
+void StubParaSet(BreakerParaInfoDef *info, uint8_t pole, uint32_t anQ4);
+
+#endif
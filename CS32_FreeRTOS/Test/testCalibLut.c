@@ -0,0 +1,103 @@
+/*
+*********************************************************************************************************
+*	ģ: У׼ұ
+*	ļ: testCalibLut.c
+*	˵    : breakerAdc.cĬУ׼(CalibMeterReInit)CalibLutInit󣬶20kAµÿQ4ֵ
+*			   Ƚ϶㻻CountCalibAnQ4븡οcountbreakerParaAnCountAnRawRmsһ¡
+*			   about.hеǰDEV_TYPEԣ޼CALIB_REL_ERR_MAX
+*********************************************************************************************************
+*/
+#include <stdio.h>
+#include <math.h>
+
+#include "bsp.h"
+#include "about.h"
+#include "breakerAdc.h"
+#include "calibMeterMem.h"
+
+#define CALIB_RAW_MAX			4095		/* 12λADCֵޣͬbreakerAdc.cADC_RAW_MAX */
+#define CALIB_AN_CHECK_MAX		20000.0f	/* ֻȽ20kA£ֵѳʵ */
+#define CALIB_REL_CHECK_MIN		20.0f		/* ֻ20AͳƣС */
+#define CALIB_ABS_ERR_MAX		0.5f		/* 20Aľ(A) */
+
+/* ޣ250Aֶߵνӵڲұнڵ㣬Լ0.02%20A
+ * ΪԶQ4ض(1/16A)£400Aͬһ */
+#if (DEV_TYPE_250A == DEV_TYPE)
+#define CALIB_REL_ERR_MAX		0.005
+#elif (DEV_TYPE_400A == DEV_TYPE)
+#define CALIB_REL_ERR_MAX		0.005
+#elif (DEV_TYPE_630A == DEV_TYPE)
+#define CALIB_REL_ERR_MAX		0.003
+#else
+#define CALIB_REL_ERR_MAX		0.001
+#endif
+
+/* ο㣬breakerAdc.cж壬δͷļ */
+float countbreakerParaAn(uint8_t idx, float fftAn, CalibInfoDef *para);
+
+static int TestPhase(uint8_t idx, CalibInfoDef *para, const char *name)
+{
+	double relMax = 0;
+	double absMax = 0;
+	double err = 0;
+	float relAt = 0;
+	float ref = 0;
+	float an = 0;
+	float raw = 0;
+	uint32_t rawQ4 = 0;
+	uint32_t anQ4 = 0;
+	uint32_t invBad = 0;
+
+	for(rawQ4=0; rawQ4<=(CALIB_RAW_MAX<<RMS_FRAC_BITS); rawQ4++)
+	{
+		raw = (float)rawQ4 / (1<<RMS_FRAC_BITS);
+		ref = countbreakerParaAn(idx, raw, para);
+		if(ref > CALIB_AN_CHECK_MAX)
+		{
+			continue;
+		}
+		anQ4 = CountCalibAnQ4(idx, rawQ4);
+		an = (float)anQ4 / (1<<RMS_FRAC_BITS);
+		err = fabs(an - ref);
+		if(ref < CALIB_REL_CHECK_MIN)
+		{
+			if(err > absMax)
+			{
+				absMax = err;
+			}
+		}
+		else if(err/ref > relMax)
+		{
+			relMax = err/ref;
+			relAt = raw;
+		}
+
+		/* 㣺CountAnRawRmsõֵ㣬Ӧصͬһֵ */
+		if((ref >= CALIB_REL_CHECK_MIN) && (0 == (rawQ4 % 7)))
+		{
+			if(CountCalibAnQ4(idx, (uint32_t)(CountAnRawRms(idx, an)*(1<<RMS_FRAC_BITS))) != anQ4)
+			{
+				invBad++;
+			}
+		}
+	}
+
+	printf("%s: max rel %.3f%% at raw %.2f (limit %.3f%%), max abs below %dA %.3f A, inverse mismatches %u\r\n",
+		name, relMax*100, relAt, CALIB_REL_ERR_MAX*100, (int)CALIB_REL_CHECK_MIN, absMax, invBad);
+	return ((relMax <= CALIB_REL_ERR_MAX) && (absMax <= CALIB_ABS_ERR_MAX) && (0 == invBad)) ? 0 : 1;
+}
+
+int main(void)
+{
+	int fail = 0;
+
+	CalibMeterReInit();
+	CalibLutInit();
+
+	fail |= TestPhase(IA_IDX, &calibMeterEx.ia, "IA");
+	fail |= TestPhase(IB_IDX, &calibMeterEx.ib, "IB");
+	fail |= TestPhase(IC_IDX, &calibMeterEx.ic, "IC");
+
+	printf("testCalibLut (DEV_TYPE %d): %s\r\n", DEV_TYPE, fail ? "FAIL" : "PASS");
+	return fail;
+}
@@ -0,0 +1,347 @@
+/*
+*********************************************************************************************************
+*	ģ: ʱʱֲ
+*	ļ: testLongDelay.c
+*	˵    : currProtectorLongDelay.c(I2T)ԭdoubleȼۼڶԱȶڣ
+*			   ԭʵÿۼ Q_MAX_STEP/((6*Ir1/I)^2*t1)ﵽINVERSE_TIME_Q_MAXֵQ_DECAY_Sȴ
+*			   1.㶨أ1
+*			   2.5%ĳأһ(LONG_DELAY_EVAL_MS)
+*			   3.Ъ(ֵȴ)һڣʵֶʱԭʵֵ붯֮
+*			     һڵ(ӽֵʱȴƽ⣬΢СӦܳʱ)
+*			   ֵжʹͬһֵ
+*			   4.(I2T/SI/VI/EI/DT)1.5/2/4/6/10Ir1㶨µĶʱ䣬currProtectorLongDelay.h
+*			     IECʽȽϣһڣSILongDelayHeatSilog2
+*********************************************************************************************************
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "currProtectorLongDelay.h"
+#include "currProtector.h"
+#include "about.h"
+#include "protectorStub.h"
+
+#define LD_FRAME_MAX			600000		/* 60HzԼ83 */
+#define LD_AN_MAX				4095		/* У׼¾ֵ(Q8)32λĵ(A) */
+
+/* ԭʵ(currProtectorLongDelay.h)ĳ */
+#define INVERSE_TIME_Q_MAX		(90000)
+
+static uint32_t profile[LD_FRAME_MAX];		/* A(AQ4) */
+static double qOld[LD_FRAME_MAX];			/* ԭʵָڵۼƣ㶯ڲӦ */
+
+/*
+*********************************************************************************************************
+*	  : RunOld
+*	˵: ԭdoubleȼۼơԭȴAN_COUNT_PERIOD_DECAYΪ꣬60HzʱضΪ0
+*			  ˴ͼ(Q_DECAY_Sֵȴ0)ȡȷֵqOld
+*	  ֵ: ״δﵽţδΪ-1
+*********************************************************************************************************
+*/
+static long RunOld(long n, uint16_t ir1, uint16_t tsMs, uint32_t pickMsQ8, uint16_t countFreq)
+{
+	double q = 0;
+	double an = 0;
+	double s = 0;
+	double step = (double)(INVERSE_TIME_Q_MAX*1000/countFreq);
+	double decay = (double)INVERSE_TIME_Q_MAX/Q_DECAY_S/countFreq;
+	uint32_t gearIr1Mul6 = 6*ir1;
+	long trip = -1;
+	long k = 0;
+
+	for(k=0; k<n; k++)
+	{
+		if(profile[k]*profile[k] >= pickMsQ8)
+		{
+			an = (double)profile[k] / (1<<RMS_FRAC_BITS);
+			s = ((double)gearIr1Mul6/an) * ((double)gearIr1Mul6/an) * (double)tsMs;
+			q += step/s;
+			if((q >= INVERSE_TIME_Q_MAX) && (trip < 0))
+			{
+				trip = k;
+			}
+		}
+		else if(q > 0)
+		{
+			q -= decay;
+			if(q < 0)
+			{
+				q = 0;
+			}
+		}
+		qOld[k] = q;
+	}
+
+	return trip;
+}
+
+typedef enum
+{
+	LD_PROFILE_CONST,
+	LD_PROFILE_NOISE,
+	LD_PROFILE_INTERMIT,
+
+	LD_PROFILE_NUM,
+}LdProfileEnum;
+
+static const char *const ldProfileName[LD_PROFILE_NUM] = {"const", "noise", "intermit"};
+
+/* AУг */
+static long FillProfile(uint8_t kind, double mul, uint16_t ir1, int m)
+{
+	double x = 0;
+	long seg = 0;
+	long n = 0;
+
+	for(n=0; n<LD_FRAME_MAX; n++)
+	{
+		if(LD_PROFILE_CONST == kind)
+		{
+			x = mul;
+		}
+		else if(LD_PROFILE_NOISE == kind)
+		{
+			x = mul*(1 + ((rand()%200) - 100)/2000.0);
+		}
+		else
+		{
+			seg = (n/(200 + m*37)) % 3;						/* δĹغһ0.5Ir1ȴ */
+			x = (2 == seg) ? 0.5 : mul*(1 + ((rand()%200) - 100)/2000.0);
+		}
+		profile[n] = (uint32_t)(x*ir1*(1<<RMS_FRAC_BITS));
+	}
+
+	return n;
+}
+
+static long RunNew(long n)
+{
+	BreakerParaInfoDef info;
+	long k = 0;
+
+	memset(&info, 0, sizeof(info));
+	stubTripMask = 0;
+	for(k=0; k<n; k++)
+	{
+		StubParaSet(&info, 0, profile[k]);
+		if(LongDelayProtector(&info))
+		{
+			return (stubTripMask & PHASE_A_BITMASK) ? k : -2;
+		}
+	}
+
+	return -1;
+}
+
+/* װ߼ֵȼ估 */
+static void LongDelaySetup(uint8_t curve, uint16_t ir1, uint16_t tsMs, uint32_t pickMsQ8)
+{
+	uint8_t i = 0;
+	BreakerParaInfoDef info;
+
+	memset(&info, 0, sizeof(info));
+	SetLongDelayCurve(curve);
+	currProtectorCfg.longDelay.gear = ir1;
+	currProtectorCfg.longDelay.tsMs = tsMs;
+	currProtectorCfg.longDelay.isInverseTime = true;
+	for(i=0; i<CURR_POLE_NUM; i++)
+	{
+		currPickupMs.longDelay[i] = pickMsQ8;
+	}
+	LongDelayCurveFresh();
+
+	currProtectorCfg.longDelay.isEnable = false;
+	LongDelayProtector(&info);
+	currProtectorCfg.longDelay.isEnable = true;
+	ClrLongDelayProtectFlag();
+	LongDelayCool(0);
+}
+
+/* currProtectorLongDelay.hиߵĶʱ(ms)r = I/Ir1 */
+static double CurveTripMs(uint8_t curve, double r, uint16_t tsMs)
+{
+	switch(curve)
+	{
+		case LONG_DELAY_CURVE_I2T:
+			return 36*tsMs/(r*r);
+		case LONG_DELAY_CURVE_SI:
+			return (pow(6, 0.02) - 1)*tsMs/(pow(r, 0.02) - 1);
+		case LONG_DELAY_CURVE_VI:
+			return 5*tsMs/(r - 1);
+		case LONG_DELAY_CURVE_EI:
+			return 35*tsMs/(r*r - 1);
+		default:
+			return tsMs;
+	}
+}
+
+/* 㶨ʱIECʽȽ */
+static int TestCurves(void)
+{
+	static const uint16_t freqTab[] = {50, 60};
+	static const uint16_t ir1Tab[] = {100, 250, 400};
+	static const uint16_t tsTab[] = {3000, 18000};
+	static const double mulTab[] = {1.5, 2, 4, 6, 10};
+	uint32_t pickQ4 = 0;
+	uint32_t pickMsQ8 = 0;
+	uint16_t countFreq = 0;
+	uint16_t evalFrames = 0;
+	double expFrames = 0;
+	double diff = 0;
+	double worst[LONG_DELAY_CURVE_NUM] = {0};
+	long n = 0;
+	long kNew = 0;
+	uint32_t cases = 0;
+	int fail = 0;
+	int c, f, a, b, m;
+
+	for(c=0; c<LONG_DELAY_CURVE_NUM; c++)
+	{
+		for(f=0; f<2; f++)
+		{
+			phaseFreq = freqTab[f];
+			countFreq = AN_COUNT_FREQ;
+			evalFrames = LONG_DELAY_EVAL_MS*countFreq/1000;
+			for(a=0; a<3; a++)
+			{
+				pickQ4 = ((uint32_t)ir1Tab[a]*DELAY_ACTION_PERCENT/100) << RMS_FRAC_BITS;
+				pickMsQ8 = pickQ4*pickQ4;
+				for(b=0; b<2; b++)
+				{
+					for(m=0; m<5; m++)
+					{
+						expFrames = CurveTripMs(c, mulTab[m], tsTab[b])*countFreq/1000;
+						n = (long)expFrames + 2*evalFrames;
+						if((mulTab[m]*ir1Tab[a] > LD_AN_MAX) || (n > LD_FRAME_MAX))
+						{
+							continue;
+						}
+						FillProfile(LD_PROFILE_CONST, mulTab[m], ir1Tab[a], 0);
+						LongDelaySetup(c, ir1Tab[a], tsTab[b], pickMsQ8);
+						kNew = RunNew(n);
+						diff = fabs((kNew + 1) - expFrames);
+						if(diff > worst[c])
+						{
+							worst[c] = diff;
+						}
+						if((kNew < 0) || (diff > evalFrames))
+						{
+							printf("%s F%d Ir1 %d t1 %d x%.1f: expect %.1f frames, trip at %ld\r\n",
+								GetLongDelayCurveDesc()->name, countFreq, ir1Tab[a], tsTab[b], mulTab[m], expFrames, kNew + 1);
+							fail = 1;
+						}
+						cases++;
+					}
+				}
+			}
+		}
+		printf("curve %s: worst |trip - IEC| %.2f frames (limit one %dms window)\r\n",
+			GetLongDelayCurveDesc()->name, worst[c], LONG_DELAY_EVAL_MS);
+	}
+	printf("%u curve cases\r\n", cases);
+
+	return fail;
+}
+
+int main(void)
+{
+	static const uint16_t freqTab[] = {50, 60};
+	static const uint16_t ir1Tab[] = {100, 160, 250, 400, 630};
+	static const uint16_t tsTab[] = {3000, 9000, 18000};
+	uint32_t pickQ4 = 0;
+	uint32_t pickMsQ8 = 0;
+	uint16_t countFreq = 0;
+	uint16_t evalFrames = 0;
+	uint16_t ir1 = 0;
+	uint16_t ts = 0;
+	double mul = 0;
+	double heatTol = 0;
+	double heatErr = 0;
+	double worstHeat = 0;
+	long worst[LD_PROFILE_NUM] = {0};
+	long n = 0;
+	long kOld = 0;
+	long kNew = 0;
+	long diff = 0;
+	uint32_t cases = 0;
+	bool isBad = false;
+	int fail = 0;
+	int f, a, b, m, kind;
+
+	srand(1);
+	for(f=0; f<2; f++)
+	{
+		phaseFreq = freqTab[f];
+		countFreq = AN_COUNT_FREQ;
+		evalFrames = LONG_DELAY_EVAL_MS*countFreq/1000;
+		for(a=0; a<5; a++)
+		{
+			for(b=0; b<3; b++)
+			{
+				ir1 = ir1Tab[a];
+				ts = tsTab[b];
+				pickQ4 = ((uint32_t)ir1*DELAY_ACTION_PERCENT/100) << RMS_FRAC_BITS;
+				pickMsQ8 = pickQ4*pickQ4;
+				for(m=0; m<40; m++)
+				{
+					mul = 1.12 + m*0.25;
+					if(mul*ir1*1.05 > LD_AN_MAX)
+					{
+						break;
+					}
+					for(kind=0; kind<LD_PROFILE_NUM; kind++)
+					{
+						if((LD_PROFILE_NOISE == kind) && (mul*0.95*100 < DELAY_ACTION_PERCENT))
+						{
+							continue;								/* ֵڼЪ */
+						}
+						n = FillProfile(kind, mul, ir1, m);
+						LongDelaySetup(LONG_DELAY_CURVE_I2T, ir1, ts, pickMsQ8);
+						kOld = RunOld(n, ir1, ts, pickMsQ8, countFreq);
+						kNew = RunNew(n);
+						diff = labs(kOld - kNew);
+						if(diff > worst[kind])
+						{
+							worst[kind] = diff;
+						}
+						isBad = ((kOld < 0) || (kNew < 0));
+						if(LD_PROFILE_CONST == kind)
+						{
+							isBad = isBad || (diff > 1);
+						}
+						else if(LD_PROFILE_NOISE == kind)
+						{
+							isBad = isBad || (diff > evalFrames);
+						}
+						else if(!isBad && (diff > evalFrames))
+						{
+							/* һڵ1.05mul */
+							heatTol = evalFrames*(double)(INVERSE_TIME_Q_MAX*1000/countFreq)*(mul*1.05/6)*(mul*1.05/6)*1000/ts;
+							heatErr = fabs(qOld[kNew] - INVERSE_TIME_Q_MAX);
+							if(heatErr/INVERSE_TIME_Q_MAX > worstHeat)
+							{
+								worstHeat = heatErr/INVERSE_TIME_Q_MAX;
+							}
+							isBad = (heatErr > heatTol);
+						}
+						if(isBad)
+						{
+							printf("%s F%d Ir1 %d t1 %d x%.2f: old %ld new %ld\r\n", ldProfileName[kind], countFreq, ir1, ts, mul, kOld, kNew);
+							fail = 1;
+						}
+						cases++;
+					}
+				}
+			}
+		}
+	}
+
+	printf("%u profiles, worst trip-frame diff: const %ld (limit 1), noise %ld (limit one %dms window), intermit %ld\r\n",
+		cases, worst[LD_PROFILE_CONST], worst[LD_PROFILE_NOISE], LONG_DELAY_EVAL_MS, worst[LD_PROFILE_INTERMIT]);
+	printf("intermit beyond one window: worst old-heat error at new trip %.4f%% of Q_MAX\r\n", worstHeat*100);
+	fail |= TestCurves();
+	printf("testLongDelay: %s\r\n", fail ? "FAIL" : "PASS");
+	return fail;
+}
@@ -0,0 +1,225 @@
+/*
+*********************************************************************************************************
+*	ģ: ʱ
+*	ļ: testShortDelay.c
+*	˵    : currProtectorShortDelay.c㶨麬բʱPROTECT_COST_MSĶʱ䣺
+*			   I^2t-ONIڹյ8Ir2(Ir2 = gear%*Ir1)ʱ t = t2*(8*Ir2/I)^2յϼI^2t-OFFʱ t = t2
+*			   1ڣڶֵļ϶SHORT_DELAY_RESET_MSʱۼ֣ﵽʱ
+*********************************************************************************************************
+*/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "currProtectorShortDelay.h"
+#include "currProtectorLongDelay.h"
+#include "currProtector.h"
+#include "protectorStub.h"
+
+#define SD_FRAME_MAX			200000		/*  */
+#define SD_AN_MAX				4095		/* У׼¾ֵ(Q8)32λĵ(A) */
+#define SD_RAW_MS_NONE			0xFFFFFFFF	/* ADC̵ޣͬCountAnRawMsQ8 */
+
+/* У׼(A)ľֵޣͬCurrPickupFresh */
+static uint32_t PickupMsQ8(uint32_t an)
+{
+	uint32_t anQ4 = an << RMS_FRAC_BITS;
+
+	return (an > SD_AN_MAX) ? SD_RAW_MS_NONE : anQ4*anQ4;
+}
+
+/* װֵۼ */
+static void ShortDelaySetup(uint16_t ir1, uint16_t gear, uint16_t tsMs, bool isI2t)
+{
+	BreakerParaInfoDef info;
+	uint8_t i = 0;
+
+	memset(&info, 0, sizeof(info));
+	currProtectorCfg.longDelay.gear = ir1;
+	currProtectorCfg.shortDelay.gear = gear;
+	currProtectorCfg.shortDelay.tsMs = tsMs;
+	currProtectorCfg.shortDelay.isInverseTime = isI2t;
+	for(i=0; i<CURR_POLE_NUM; i++)
+	{
+		currPickupMs.shortDelay[i] = PickupMsQ8((uint32_t)gear*ir1*SHORT_DELAY_ACTION_PERCENT/100/100);
+		currPickupMs.shortDelayDef[i] = PickupMsQ8((uint32_t)SHORT_DELAY_I2T_KNEE_IR2*gear*ir1/100);
+	}
+	ShortDelayI2tFresh();
+
+	currProtectorCfg.shortDelay.isEnable = false;
+	ShortDelayProtector(&info);
+	currProtectorCfg.shortDelay.isEnable = true;
+	ClrShortDelayProtectFlag();
+	stubTripMask = 0;
+}
+
+/* A㶨anQ4룬صΪֹδ0 */
+static long RunConst(BreakerParaInfoDef *info, uint32_t anQ4, long frameMax)
+{
+	long k = 0;
+
+	StubParaSet(info, 0, anQ4);
+	for(k=1; k<=frameMax; k++)
+	{
+		if(ShortDelayProtector(info))
+		{
+			return (stubTripMask & PHASE_A_BITMASK) ? k : -1;
+		}
+	}
+
+	return 0;
+}
+
+/* ߹涨Ķʱ(ms) */
+static double CurveMs(uint16_t gear, uint16_t tsMs, bool isI2t, double r)
+{
+	double kneeR = (double)SHORT_DELAY_I2T_KNEE_IR2*gear/100;
+
+	if(isI2t && (r < kneeR))
+	{
+		return tsMs*(kneeR/r)*(kneeR/r);
+	}
+
+	return tsMs;
+}
+
+/*
+*********************************************************************************************************
+*	  : CheckCurve
+*	˵: 鶯ʱ䣬r = I/Ir1ڶֵIr2ʱӦ
+*	  ֵ: ʧܵ
+*********************************************************************************************************
+*/
+static int CheckCurve(uint16_t ir1, uint16_t gear, uint16_t tsMs, bool isI2t, double r, double *errMax)
+{
+	BreakerParaInfoDef info;
+	double frameMs = 1000.0/AN_COUNT_FREQ;
+	double te = 0;
+	double tm = 0;
+	long k = 0;
+
+	memset(&info, 0, sizeof(info));
+	ShortDelaySetup(ir1, gear, tsMs, isI2t);
+	k = RunConst(&info, (uint32_t)(r*ir1*(1<<RMS_FRAC_BITS) + 0.5), SD_FRAME_MAX);
+	if(r*100 < gear)
+	{
+		if(0 != k)
+		{
+			printf("Ir1 %d Ir2 %d%% r %.2f: tripped below pickup\r\n", ir1, gear, r);
+			return 1;
+		}
+		return 0;
+	}
+
+	te = CurveMs(gear, tsMs, isI2t, r);
+	tm = k*frameMs + PROTECT_COST_MS;
+	if(fabs(tm - te) > *errMax)
+	{
+		*errMax = fabs(tm - te);
+	}
+	if((k <= 0) || (fabs(tm - te) > frameMs))
+	{
+		printf("Ir1 %d Ir2 %d%% t2 %d %s r %.2f: trip %.1fms, curve %.1fms\r\n",
+			ir1, gear, tsMs, isI2t ? "ON" : "OFF", r, tm, te);
+		return 1;
+	}
+
+	return 0;
+}
+
+/* λʱ䣺10ںڶֵdipڣٴιʱʣද */
+static int CheckReset(void)
+{
+	BreakerParaInfoDef info;
+	uint16_t resetCnt = 0;
+	uint32_t anQ4 = (10*250) << RMS_FRAC_BITS;
+	long full = 0;
+	long k = 0;
+	long expect = 0;
+	int dip = 0;
+	int j = 0;
+	int fail = 0;
+
+	memset(&info, 0, sizeof(info));
+	phaseFreq = 50;
+	resetCnt = (uint32_t)SHORT_DELAY_RESET_MS*AN_COUNT_FREQ/1000;
+	ShortDelaySetup(250, 600, 300, false);
+	full = RunConst(&info, anQ4, SD_FRAME_MAX);
+
+	for(dip=1; dip<=2*resetCnt; dip++)
+	{
+		ShortDelaySetup(250, 600, 300, false);
+		StubParaSet(&info, 0, anQ4);
+		for(j=0; j<10; j++)
+		{
+			ShortDelayProtector(&info);
+		}
+		StubParaSet(&info, 0, 0);
+		for(j=0; j<dip; j++)
+		{
+			ShortDelayProtector(&info);
+		}
+		k = RunConst(&info, anQ4, SD_FRAME_MAX);
+		expect = (dip < resetCnt) ? (full - 10) : full;
+		if(k != expect)
+		{
+			printf("reset: dip %d frames, %ld frames to trip, expect %ld\r\n", dip, k, expect);
+			fail = 1;
+		}
+	}
+	printf("reset: dips of 1..%d frames checked, state kept below %d frames (%dms)\r\n", 2*resetCnt, resetCnt, SHORT_DELAY_RESET_MS);
+
+	return fail;
+}
+
+int main(void)
+{
+	static const uint16_t freqTab[] = {50, 60};
+	static const uint16_t ir1Tab[] = {100, 160, 250, 320};
+	static const uint16_t gearTab[] = {200, 400, 600, 1000};
+	static const uint16_t tsTab[] = {100, 200, 300, 400, 500};
+	double errMax = 0;
+	double r = 0;
+	uint32_t cases = 0;
+	int fail = 0;
+	int f, a, g, t, on;
+
+	for(f=0; f<2; f++)
+	{
+		phaseFreq = freqTab[f];
+		for(a=0; a<4; a++)
+		{
+			for(g=0; g<4; g++)
+			{
+				for(t=0; t<5; t++)
+				{
+					for(on=0; on<2; on++)
+					{
+						/* 2~12Ir1 */
+						for(r=2; r<=12.001; r+=0.5)
+						{
+							fail |= CheckCurve(ir1Tab[a], gearTab[g], tsTab[t], on, r, &errMax);
+							cases++;
+						}
+						/* յ㸽0.8~1.58*Ir2У׼²ADC */
+						for(r=0.8; r<=1.501; r+=0.05)
+						{
+							if(r*SHORT_DELAY_I2T_KNEE_IR2*gearTab[g]*ir1Tab[a]/100 > SD_AN_MAX)
+							{
+								break;
+							}
+							fail |= CheckCurve(ir1Tab[a], gearTab[g], tsTab[t], on, r*SHORT_DELAY_I2T_KNEE_IR2*gearTab[g]/100, &errMax);
+							cases++;
+						}
+					}
+				}
+			}
+		}
+	}
+	printf("curve: %u points, max |trip-curve| %.2f ms (limit one frame, 8.3~10ms)\r\n", cases, errMax);
+
+	fail |= CheckReset();
+
+	printf("testShortDelay: %s\r\n", fail ? "FAIL" : "PASS");
+	return fail;
+}
@@ -0,0 +1,203 @@
+/*
+*********************************************************************************************************
+*	ģ: 
+*	ļ: testSumStat.c
+*	˵    : 1.SqrtU32doubleƽȡȶ(ȫȫƽࡢ32λΧ)
+*			   2.CountSumStatDMA粽ͳ + breakerAdc.cQ4̣ԭ"ȥ +
+*			     sqrSumAverSqrt"̱ȽϾ
+*			   3.ʱعοĿܣFPU㿪ֻ輸ڣM0FPU
+*			     sqrt/⡣ĿADC_PROBE_SUM_STAT̽ʵ⣺breakerAdc.h
+*			     ADC_PROBE_ENΪ1ԴڷADC_PROBE_DUMP_CMDSumStatһ(ϼƵCPU)
+*********************************************************************************************************
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <float.h>
+
+#include "usrLib.h"
+#include "breakerAdc.h"
+
+#define BENCH_LOOPS			200000		/* ʱο֡ */
+#define RMS_ERR_MAX_AN		(1.0/(1<<RMS_FRAC_BITS) + 4096*FLT_EPSILON)	/* Q4ض1/16ADCֵӲοֵfloat */
+
+static int16_t dmaBuf[NPT][ADC_CHANLS_NUM];		/* [][ͨ]ţDMAһ */
+static uint32_t fftIn[NPT];
+
+/* ԭʵ(usrLib.c)ƽƽÿ⺯ */
+static float sqrSumAverSqrt(uint32_t *data, uint32_t len)
+{
+	uint32_t sum = 0;
+	uint16_t i = 0;
+	float aver = 0;
+	float sqrtAver = 0;
+
+	for(i=0; i<len; i++)
+	{
+		sum += data[i]*data[i];
+	}
+
+	aver = ((float)sum) / ((float)len);
+	sqrtAver = sqrt(aver);
+	return sqrtAver;
+}
+
+/* ԭ̣ȰһͨĲֵӽټ */
+static float OldRms(uint8_t ch)
+{
+	uint16_t i = 0;
+
+	for(i=0; i<NPT; i++)
+	{
+		fftIn[i] = (uint16_t)dmaBuf[i][ch];
+	}
+	return sqrSumAverSqrt(fftIn, NPT);
+}
+
+/* ̣粽ͳƺCountFFTParasFromStatQ4ֱֵ */
+static float NewRms(uint8_t ch)
+{
+	SumStatDef stat;
+	uint32_t sqrAverQ8 = 0;
+
+	CountSumStat(&dmaBuf[0][ch], NPT, ADC_CHANLS_NUM, &stat);
+	sqrAverQ8 = stat.sqrSum * ((1<<(2*RMS_FRAC_BITS))/NPT);
+	return (float)SqrtU32(sqrAverQ8) / (1<<RMS_FRAC_BITS);
+}
+
+/* һڵĲֱƫ +  + 3г޷12λ */
+static void FillWave(uint8_t ch, double dc, double amp, double h3, double phase)
+{
+	uint16_t i = 0;
+	double v = 0;
+
+	for(i=0; i<NPT; i++)
+	{
+		v = dc + amp*sin(2*M_PI*i/NPT + phase) + h3*sin(3*2*M_PI*i/NPT);
+		if(v < 0)
+		{
+			v = 0;
+		}
+		if(v > 4095)
+		{
+			v = 4095;
+		}
+		dmaBuf[i][ch] = (int16_t)lround(v);
+	}
+}
+
+static double NowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+static int TestSqrt(void)
+{
+	uint64_t v = 0;
+	uint32_t r = 0;
+	uint32_t bad = 0;
+	int64_t d = 0;
+
+	for(r=0; r<=0xFFFF; r++)
+	{
+		for(d=-1; d<=1; d++)
+		{
+			v = (uint64_t)r*r + d;
+			if(v > 0xFFFFFFFFull)
+			{
+				continue;
+			}
+			if(SqrtU32((uint32_t)v) != (uint32_t)floor(sqrt((double)v)))
+			{
+				bad++;
+			}
+		}
+	}
+	for(v=0; v<=0xFFFFFFFFull; v+=977)
+	{
+		if(SqrtU32((uint32_t)v) != (uint32_t)floor(sqrt((double)v)))
+		{
+			bad++;
+		}
+	}
+	if(SqrtU32(0xFFFFFFFFu) != 0xFFFF)
+	{
+		bad++;
+	}
+
+	printf("SqrtU32: %u mismatches\r\n", bad);
+	return (0 == bad) ? 0 : 1;
+}
+
+static int TestRmsAccuracy(void)
+{
+	double amp = 0;
+	double errMax = 0;
+	double err = 0;
+	uint16_t k = 0;
+	uint32_t cnt = 0;
+
+	for(amp=0; amp<=2047; amp+=3.7)
+	{
+		for(k=0; k<8; k++)
+		{
+			FillWave(IA_IDX, 2048 + (k-4)*7.3, amp, amp*0.1*(k&1), k*0.41);
+			err = fabs((double)NewRms(IA_IDX) - (double)OldRms(IA_IDX));
+			if(err > errMax)
+			{
+				errMax = err;
+			}
+			cnt++;
+		}
+	}
+
+	printf("RMS: %u frames, max |int-float| = %.4f An (limit %.4f)\r\n", cnt, errMax, RMS_ERR_MAX_AN);
+	return (errMax <= RMS_ERR_MAX_AN) ? 0 : 1;
+}
+
+static void HostTimeRms(void)
+{
+	volatile float sink = 0;
+	double t0 = 0;
+	double tOld = 0;
+	double tNew = 0;
+	uint32_t i = 0;
+
+	FillWave(IA_IDX, 2048, 1500, 150, 0.3);
+	FillWave(IB_IDX, 2048, 1500, 150, 2.4);
+	FillWave(IC_IDX, 2048, 1500, 150, 4.5);
+
+	t0 = NowNs();
+	for(i=0; i<BENCH_LOOPS; i++)
+	{
+		sink = OldRms(IA_IDX) + OldRms(IB_IDX) + OldRms(IC_IDX);
+	}
+	tOld = (NowNs() - t0) / BENCH_LOOPS;
+
+	t0 = NowNs();
+	for(i=0; i<BENCH_LOOPS; i++)
+	{
+		sink = NewRms(IA_IDX) + NewRms(IB_IDX) + NewRms(IC_IDX);
+	}
+	tNew = (NowNs() - t0) / BENCH_LOOPS;
+	(void)sink;
+
+	printf("host timing, NOT representative of Cortex-M0 (host has an FPU; measure target cycles with ADC_PROBE_SUM_STAT):\r\n");
+	printf("  3-phase frame (NPT=%d): copy+float %.1f ns, stride+int %.1f ns\r\n", NPT, tOld, tNew);
+}
+
+int main(void)
+{
+	int fail = 0;
+
+	fail |= TestSqrt();
+	fail |= TestRmsAccuracy();
+	HostTimeRms();
+
+	printf("testSumStat: %s\r\n", fail ? "FAIL" : "PASS");
+	return fail;
+}
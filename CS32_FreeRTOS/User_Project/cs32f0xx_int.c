@@ -16,8 +16,6 @@
 #include "task.h"
 #include "bsp.h"
 
-extern osSemaphoreId BinarySemAdcConvCpltHandle;
-
 /** @addtogroup CS32F0xx_DEMO_Examples
   * @{
   */
@@ -139,13 +137,36 @@ void DebugMon_Handler(void)
 void DMA1_Channel1_IRQHandler(void)
 {
 
+    /* Test on DMA1 Channel1 Half Transfer interrupt */
+    if(dma_interrupt_status_get(DMA1_INT_HLF1))
+    {
+        /* Clear DMA1 Channel1 Half Transfer interrupt bit */
+        dma_interrupt_flag_clear(DMA1_INT_HLF1);
+        AdcDmaXferCpltCallback(ADC_DMA_HALF_FIRST);
+    }
+
     /* Test on DMA1 Channel1 Transfer Complete interrupt */
     if(dma_interrupt_status_get(DMA1_INT_CMP1))
     {
-        /* Clear DMA1 Channel1 Half Transfer, Transfer Complete and  interrupt  bits */
-        dma_interrupt_flag_clear(DMA1_INT_G1);
-        osSemaphoreRelease(BinarySemAdcConvCpltHandle);
+        /* Clear DMA1 Channel1 Transfer Complete interrupt bit */
+        dma_interrupt_flag_clear(DMA1_INT_CMP1);
+        AdcDmaXferCpltCallback(ADC_DMA_HALF_SECOND);
+    }
+}
+
 
+/**
+  * @fn void ADC1_IRQHandler(void)
+  * @brief  This function handles ADC1 interrupt request.
+  * @param  None
+  * @return None
+  */
+void ADC1_IRQHandler(void)
+{
+    /* Test on ADC1 analog watchdog interrupt */
+    if(adc_intetrrupt_status_get(ADC1, ADC_INTR_WDEVT))
+    {
+        AdcWatchdogIrqHandler();
     }
 }
 